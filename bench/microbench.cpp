@@ -0,0 +1,274 @@
+// microbenchmarks of the routines the search spends its time in. each one is
+// run over the bench positions, see bench.hpp, and counts one item per position
+// or move. to compare two builds write the results out as json:
+//
+//   pawntificate-microbench --benchmark_out=before.json --benchmark_out_format=json
+//
+// and compare the files with the compare.py tool that comes with the library.
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <pawntificate/bench.hpp>
+#include <pawntificate/board.hpp>
+#include <pawntificate/evaluate.hpp>
+#include <pawntificate/nnue.hpp>
+#include <pawntificate/pawns.hpp>
+
+namespace {
+
+// the bench positions, parsed once.
+auto positions() -> const std::vector<pawntificate::board> & {
+  static const auto boards = [] {
+    std::vector<pawntificate::board> boards;
+    for (const auto fen : pawntificate::bench_positions) {
+      pawntificate::board b;
+      if (pawntificate::parse_fen(fen, b)) {
+        boards.push_back(b);
+      }
+    }
+
+    return boards;
+  }();
+
+  return boards;
+}
+
+// every legal move of every bench position.
+auto position_moves() -> const std::vector<std::pair<pawntificate::board, pawntificate::move>> & {
+  static const auto moves = [] {
+    std::vector<std::pair<pawntificate::board, pawntificate::move>> moves;
+    pawntificate::move_list legal;
+    for (const auto &b : positions()) {
+      pawntificate::find_legal_moves(b, legal);
+      for (const auto m : legal) {
+        moves.emplace_back(b, m);
+      }
+    }
+
+    return moves;
+  }();
+
+  return moves;
+}
+
+template <typename T>
+auto write(std::ofstream &out, const T value) -> void {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// writes count random weights of type T in [-limit, limit].
+template <typename T>
+auto write_random(std::ofstream &out, std::mt19937 &gen, const std::size_t count, const int limit) -> void {
+  std::uniform_int_distribution<int> dist{-limit, limit};
+  for (auto i = 0ul; i < count; ++i) {
+    write(out, static_cast<T>(dist(gen)));
+  }
+}
+
+// a network of random weights, built the same way as the one in the tests.
+// the cost of evaluating doesn't depend on the values of the weights.
+auto network() -> const pawntificate::nnue::network & {
+  namespace nnue = pawntificate::nnue;
+
+  static const auto net = [] {
+    const auto path = std::filesystem::temp_directory_path() / "pawntificate_microbench_nnue.bin";
+    {
+      std::mt19937 gen{42};
+      std::ofstream out{path, std::ios::binary};
+
+      out.write(nnue::magic.data(), nnue::magic.size());
+      write(out, nnue::version);
+      write(out, static_cast<std::uint32_t>(nnue::half_dimensions));
+      write(out, static_cast<std::uint32_t>(nnue::hidden_dimensions));
+      for (auto i = nnue::magic.size() + 12; i < nnue::header_size; ++i) {
+        write(out, '\0');
+      }
+
+      write_random<std::int16_t>(out, gen, nnue::half_dimensions, 32);
+      write_random<std::int16_t>(out, gen, nnue::feature_count * nnue::half_dimensions, 8);
+      write_random<std::int32_t>(out, gen, nnue::hidden_dimensions, 256);
+      write_random<std::int8_t>(out, gen, nnue::hidden_dimensions * 2 * nnue::half_dimensions, 16);
+      write_random<std::int32_t>(out, gen, nnue::hidden_dimensions, 256);
+      write_random<std::int8_t>(out, gen, nnue::hidden_dimensions * nnue::hidden_dimensions, 16);
+      write_random<std::int32_t>(out, gen, 1, 256);
+      write_random<std::int8_t>(out, gen, nnue::hidden_dimensions, 16);
+    }
+
+    // the weights stay mapped once the file is gone.
+    auto n = std::make_unique<nnue::network>();
+    n->load(path);
+    std::filesystem::remove(path);
+    return n;
+  }();
+
+  return *net;
+}
+
+// the accumulator of each bench position.
+auto accumulators() -> const std::vector<pawntificate::nnue::accumulator> & {
+  static const auto accs = [] {
+    std::vector<pawntificate::nnue::accumulator> accs(positions().size());
+    for (auto i = 0ul; i < accs.size(); ++i) {
+      network().refresh(positions()[i], accs[i]);
+    }
+
+    return accs;
+  }();
+
+  return accs;
+}
+
+// games as the position command sends them, from a few moves in to a long one.
+constexpr std::array<std::string_view, 3> games{
+  "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6",
+  "d2d4 g8f6 c2c4 e7e6 b1c3 f8b4 e2e3 e8g8 f1d3 d7d5 g1f3 c7c5 e1g1 b8c6 a2a3 b4c3 b2c3 d5c4 d3c4 d8c7",
+  "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4 f3d4 g8f6 b1c3 a7a6 c1e3 e7e5 d4b3 c8e6 f2f3 f8e7 d1d2 e8g8 e1c1 b8d7 "
+  "g2g4 b7b5 g4g5 b5b4 c3e2 f6e8 f3f4 a6a5 f4f5 a5a4 b3d4 e5d4 e2d4 b4b3 c1b1 b3c2 d4c2 e6b3 a2b3 a4b3"
+};
+
+auto find_legal_moves(benchmark::State &state) -> void {
+  pawntificate::move_list moves;
+  for (auto _ : state) {
+    for (const auto &b : positions()) {
+      pawntificate::find_legal_moves(b, moves);
+      benchmark::DoNotOptimize(moves.size());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(positions().size()));
+}
+
+auto make_move(benchmark::State &state) -> void {
+  for (auto _ : state) {
+    for (const auto &[b, m] : position_moves()) {
+      const pawntificate::board next{b, m};
+      benchmark::DoNotOptimize(next.hash);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(position_moves().size()));
+}
+
+auto board_from_moves(benchmark::State &state) -> void {
+  for (auto _ : state) {
+    for (const auto game : games) {
+      const pawntificate::board b{game};
+      benchmark::DoNotOptimize(b.hash);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(games.size()));
+}
+
+auto parse_fen(benchmark::State &state) -> void {
+  pawntificate::board b;
+  for (auto _ : state) {
+    for (const auto fen : pawntificate::bench_positions) {
+      benchmark::DoNotOptimize(pawntificate::parse_fen(fen, b));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pawntificate::bench_positions.size()));
+}
+
+// the pawn structures are cached as they are in a search.
+auto evaluate_position(benchmark::State &state) -> void {
+  pawntificate::pawn_table pawns;
+  for (auto _ : state) {
+    for (const auto &b : positions()) {
+      benchmark::DoNotOptimize(pawntificate::evaluate_position(b, pawns));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(positions().size()));
+}
+
+// the accumulator of a position from scratch, as at the root of a search or
+// after a king move.
+auto nnue_refresh(benchmark::State &state) -> void {
+  const auto &net = network();
+  pawntificate::nnue::accumulator acc;
+  for (auto _ : state) {
+    for (const auto &b : positions()) {
+      net.refresh(b, acc);
+      benchmark::DoNotOptimize(acc);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(positions().size()));
+}
+
+// the accumulator of a child from its parent's, for every move of every
+// position.
+auto nnue_update(benchmark::State &state) -> void {
+  const auto &net = network();
+  const auto &accs = accumulators();
+  std::vector<pawntificate::board> children;
+  std::vector<std::size_t> parents;
+  pawntificate::move_list legal;
+  for (auto i = 0ul; i < positions().size(); ++i) {
+    pawntificate::find_legal_moves(positions()[i], legal);
+    for (const auto m : legal) {
+      children.emplace_back(positions()[i], m);
+      parents.push_back(i);
+    }
+  }
+
+  pawntificate::nnue::accumulator acc;
+  for (auto _ : state) {
+    for (auto i = 0ul; i < children.size(); ++i) {
+      net.update(positions()[parents[i]], accs[parents[i]], children[i], acc);
+      benchmark::DoNotOptimize(acc);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(children.size()));
+}
+
+// the forward pass through the hidden layers from an accumulator, the
+// evaluations per second of the network.
+auto nnue_evaluate(benchmark::State &state) -> void {
+  const auto &net = network();
+  const auto &accs = accumulators();
+  for (auto _ : state) {
+    for (auto i = 0ul; i < positions().size(); ++i) {
+      benchmark::DoNotOptimize(net.evaluate(positions()[i], accs[i]));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(positions().size()));
+}
+
+// the king safety check that move generation runs for every move.
+auto in_check(benchmark::State &state) -> void {
+  for (auto _ : state) {
+    for (const auto &b : positions()) {
+      benchmark::DoNotOptimize(pawntificate::in_check(b));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(positions().size()));
+}
+
+} // unnamed namespace
+
+BENCHMARK(find_legal_moves);
+BENCHMARK(make_move);
+BENCHMARK(board_from_moves);
+BENCHMARK(parse_fen);
+BENCHMARK(evaluate_position);
+BENCHMARK(nnue_refresh);
+BENCHMARK(nnue_update);
+BENCHMARK(nnue_evaluate);
+BENCHMARK(in_check);
+
+BENCHMARK_MAIN();
@@ -1,9 +1,13 @@
 #ifndef CXX_RANDOM_HPP
 #define CXX_RANDOM_HPP
 
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <random>
+#include <thread>
+
+#include "cxx/spsc_queue.hpp"
 
 namespace cxx {
 
@@ -26,6 +30,54 @@ auto serialise_random_engine(const RNG &rng,
   os << rng;
 }
 
+// keeps a log of the states of a random engine in a file, for debugging. the
+// state is copied into a ring buffer and written out on a thread of its own,
+// so recording it costs a copy rather than a trip to the disk. states are
+// appended one per line, the last line is the latest. if the writer falls
+// behind by more than N states, the newest are dropped.
+template <typename RNG, std::size_t N = 16>
+class random_engine_log {
+public:
+  explicit random_engine_log(const std::filesystem::path &file)
+  : writer{[this, file] {
+      std::ofstream os{file, std::ios::app};
+      entry e;
+      while (true) {
+        states.pop(e);
+        if (e.last) {
+          break;
+        }
+
+        os << e.rng << std::endl;
+      }
+    }} {}
+
+  random_engine_log(const random_engine_log &) = delete;
+  auto operator=(const random_engine_log &) -> random_engine_log & = delete;
+
+  // anything already recorded is written before this returns.
+  ~random_engine_log() {
+    entry e{{}, true};
+    states.push(e);
+    writer.join();
+  }
+
+  // returns false if the state was dropped.
+  auto record(const RNG &rng) -> bool {
+    entry e{rng, false};
+    return states.try_push(e);
+  }
+
+private:
+  struct entry {
+    RNG rng;
+    bool last = false;
+  };
+
+  spsc_queue<entry, N> states;
+  std::thread writer;
+};
+
 } // namespace cxx
 
 #endif // CXX_RANDOM_HPP
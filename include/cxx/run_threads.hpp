@@ -0,0 +1,29 @@
+#ifndef CXX_RUN_THREADS_HPP
+#define CXX_RUN_THREADS_HPP
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cxx {
+
+// run worker on the given number of threads, one of which is the calling
+// thread, and wait for them all to return. each is given its index, the
+// calling thread's is zero.
+template <typename F>
+auto run_threads(const std::size_t threads, F &&worker) -> void {
+  std::vector<std::thread> helpers;
+  helpers.reserve(threads - 1);
+  for (auto i = 1ul; i < threads; ++i) {
+    helpers.emplace_back(worker, i);
+  }
+
+  worker(0ul);
+  for (auto &t : helpers) {
+    t.join();
+  }
+}
+
+} // namespace cxx
+
+#endif // CXX_RUN_THREADS_HPP
@@ -0,0 +1,89 @@
+#ifndef CXX_SPSC_QUEUE_HPP
+#define CXX_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace cxx {
+
+// a fixed capacity queue between exactly one producer thread and one consumer
+// thread, without locks. elements are swapped in and out of their slots rather
+// than copied, so a queue of strings hands the same buffers back and forth
+// and stops allocating once they have grown to fit.
+template <typename T, std::size_t N>
+class spsc_queue {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+  spsc_queue() = default;
+
+  spsc_queue(const spsc_queue &) = delete;
+  auto operator=(const spsc_queue &) -> spsc_queue & = delete;
+
+  static constexpr auto capacity() -> std::size_t {
+    return N;
+  }
+
+  // producer only. returns false if the queue is full, otherwise value is
+  // swapped into the queue and left holding whatever was in its slot.
+  auto try_push(T &value) -> bool {
+    const auto t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == N) {
+      return false;
+    }
+
+    using std::swap;
+    swap(slots[t % N], value);
+    tail.store(t + 1, std::memory_order_release);
+    tail.notify_one();
+    return true;
+  }
+
+  // producer only. blocks while the queue is full.
+  auto push(T &value) -> void {
+    while (!try_push(value)) {
+      const auto h = head.load(std::memory_order_acquire);
+      if (tail.load(std::memory_order_relaxed) - h == N) {
+        head.wait(h, std::memory_order_acquire);
+      }
+    }
+  }
+
+  // consumer only. returns false if the queue is empty, otherwise the front of
+  // the queue is swapped into value.
+  auto try_pop(T &value) -> bool {
+    const auto h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    using std::swap;
+    swap(slots[h % N], value);
+    head.store(h + 1, std::memory_order_release);
+    head.notify_one();
+    return true;
+  }
+
+  // consumer only. blocks while the queue is empty.
+  auto pop(T &value) -> void {
+    while (!try_pop(value)) {
+      const auto t = tail.load(std::memory_order_acquire);
+      if (t == head.load(std::memory_order_relaxed)) {
+        tail.wait(t, std::memory_order_acquire);
+      }
+    }
+  }
+
+private:
+  // head and tail only ever increase, they are kept apart so the two threads
+  // aren't writing to the same cache line.
+  alignas(64) std::atomic<std::size_t> head{0};
+  alignas(64) std::atomic<std::size_t> tail{0};
+  alignas(64) std::array<T, N> slots{};
+};
+
+} // namespace cxx
+
+#endif // CXX_SPSC_QUEUE_HPP
@@ -0,0 +1,111 @@
+#ifndef CXX_STATIC_VECTOR_HPP
+#define CXX_STATIC_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+namespace cxx {
+
+// a vector with its storage inline and a fixed capacity, so it never allocates.
+// only for trivial types as every element is always constructed.
+template <typename T, std::size_t N>
+class static_vector {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  constexpr static_vector() = default;
+
+  constexpr static_vector(std::initializer_list<T> init) {
+    for (const auto &v : init) {
+      push_back(v);
+    }
+  }
+
+  static constexpr auto capacity() -> std::size_t {
+    return N;
+  }
+
+  constexpr auto size() const -> std::size_t {
+    return n;
+  }
+
+  constexpr auto empty() const -> bool {
+    return n == 0;
+  }
+
+  constexpr auto full() const -> bool {
+    return n == N;
+  }
+
+  constexpr auto clear() -> void {
+    n = 0;
+  }
+
+  constexpr auto push_back(const T &v) -> void {
+    assert(n < N);
+    values[n++] = v;
+  }
+
+  template <typename... Args>
+  constexpr auto emplace_back(Args &&...args) -> T & {
+    assert(n < N);
+    return values[n++] = T(std::forward<Args>(args)...);
+  }
+
+  constexpr auto pop_back() -> void {
+    assert(n > 0);
+    --n;
+  }
+
+  constexpr auto insert(const_iterator pos, const T &v) -> iterator {
+    assert(n < N);
+    const auto it = begin() + (pos - begin());
+    std::copy_backward(it, end(), end() + 1);
+    *it = v;
+    ++n;
+    return it;
+  }
+
+  constexpr auto operator[](const std::size_t i) -> T & { return values[i]; }
+  constexpr auto operator[](const std::size_t i) const -> const T & { return values[i]; }
+
+  constexpr auto front() -> T & { return values[0]; }
+  constexpr auto front() const -> const T & { return values[0]; }
+  constexpr auto back() -> T & { return values[n - 1]; }
+  constexpr auto back() const -> const T & { return values[n - 1]; }
+
+  constexpr auto data() -> T * { return values.data(); }
+  constexpr auto data() const -> const T * { return values.data(); }
+
+  constexpr auto begin() -> iterator { return values.data(); }
+  constexpr auto begin() const -> const_iterator { return values.data(); }
+  constexpr auto end() -> iterator { return values.data() + n; }
+  constexpr auto end() const -> const_iterator { return values.data() + n; }
+
+private:
+  std::array<T, N> values{};
+  std::size_t n = 0;
+};
+
+template <typename T, std::size_t N>
+constexpr auto operator==(const static_vector<T, N> &lhs, const static_vector<T, N> &rhs) -> bool {
+  return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+}
+
+template <typename T, std::size_t N>
+constexpr auto operator!=(const static_vector<T, N> &lhs, const static_vector<T, N> &rhs) -> bool {
+  return !(lhs == rhs);
+}
+
+} // namespace cxx
+
+#endif // CXX_STATIC_VECTOR_HPP
@@ -0,0 +1,20 @@
+#ifndef CXX_TO_NUMBER_HPP
+#define CXX_TO_NUMBER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+
+namespace cxx {
+
+// parse a whole number from the start of token, returning the fallback if it
+// doesn't start with one.
+inline auto to_number(const std::string_view token, const std::size_t fallback) -> std::size_t {
+  std::size_t value = fallback;
+  std::from_chars(token.data(), token.data() + token.size(), value);
+  return value;
+}
+
+} // namespace cxx
+
+#endif // CXX_TO_NUMBER_HPP
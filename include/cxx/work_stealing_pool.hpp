@@ -0,0 +1,143 @@
+#ifndef CXX_WORK_STEALING_POOL_HPP
+#define CXX_WORK_STEALING_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cxx {
+
+// a pool of threads that each own a double ended queue of tasks. a thread pushes
+// and pops its own tasks at the back of its queue and, when that is empty,
+// steals from the front of the other queues. queue 0 has no thread of its own,
+// its tasks are stolen or run by whichever thread calls run_one for it.
+class work_stealing_pool {
+public:
+  // tasks are a plain function and context pointer so pushing never allocates,
+  // the function is given the index of the thread that runs it.
+  struct task {
+    void (*run)(void *context, std::size_t thread);
+    void *context;
+  };
+
+  explicit work_stealing_pool(const std::size_t threads) : queues(threads) {
+    workers.reserve(threads - 1);
+    for (auto i = 1ul; i < threads; ++i) {
+      workers.emplace_back([this, i] {
+        while (!done.load(std::memory_order_acquire)) {
+          if (!run_one(i)) {
+            std::unique_lock lock{sleep_lock};
+            wake.wait(lock, [this] {
+              return done.load(std::memory_order_acquire) || queued.load(std::memory_order_acquire) > 0;
+            });
+          }
+        }
+      });
+    }
+  }
+
+  work_stealing_pool(const work_stealing_pool &) = delete;
+  auto operator=(const work_stealing_pool &) -> work_stealing_pool & = delete;
+
+  ~work_stealing_pool() {
+    {
+      std::lock_guard lock{sleep_lock};
+      done.store(true, std::memory_order_release);
+    }
+
+    wake.notify_all();
+    for (auto &w : workers) {
+      w.join();
+    }
+  }
+
+  auto size() const -> std::size_t {
+    return queues.size();
+  }
+
+  // returns false if the queue is full, the caller should run the task itself.
+  auto push(const std::size_t thread, const task t) -> bool {
+    auto &q = queues[thread];
+    {
+      std::lock_guard lock{q.lock};
+      if (q.tail - q.head == q.tasks.size()) {
+        return false;
+      }
+
+      q.tasks[q.tail++ % q.tasks.size()] = t;
+    }
+
+    {
+      std::lock_guard lock{sleep_lock};
+      queued.fetch_add(1, std::memory_order_release);
+    }
+
+    wake.notify_one();
+    return true;
+  }
+
+  // run a single task, newest first from our own queue otherwise the oldest
+  // task of another thread. returns false if there was nothing to do.
+  auto run_one(const std::size_t thread) -> bool {
+    task t{};
+    if (!pop_back(queues[thread], t)) {
+      bool stolen = false;
+      for (auto i = 1ul; i < queues.size() && !stolen; ++i) {
+        stolen = pop_front(queues[(thread + i) % queues.size()], t);
+      }
+
+      if (!stolen) {
+        return false;
+      }
+    }
+
+    queued.fetch_sub(1, std::memory_order_acq_rel);
+    t.run(t.context, thread);
+    return true;
+  }
+
+private:
+  // fixed capacity ring buffer, head and tail only ever increase.
+  struct queue {
+    std::mutex lock;
+    std::array<task, 256> tasks;
+    std::size_t head = 0;
+    std::size_t tail = 0;
+  };
+
+  static auto pop_back(queue &q, task &t) -> bool {
+    std::lock_guard lock{q.lock};
+    if (q.head == q.tail) {
+      return false;
+    }
+
+    t = q.tasks[--q.tail % q.tasks.size()];
+    return true;
+  }
+
+  static auto pop_front(queue &q, task &t) -> bool {
+    std::lock_guard lock{q.lock};
+    if (q.head == q.tail) {
+      return false;
+    }
+
+    t = q.tasks[q.head++ % q.tasks.size()];
+    return true;
+  }
+
+  std::vector<queue> queues;
+  std::vector<std::thread> workers;
+
+  std::atomic<bool> done{false};
+  std::atomic<std::size_t> queued{0};
+  std::mutex sleep_lock;
+  std::condition_variable wake;
+};
+
+} // namespace cxx
+
+#endif // CXX_WORK_STEALING_POOL_HPP
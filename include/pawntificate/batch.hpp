@@ -0,0 +1,58 @@
+#ifndef PAWNTIFICATE_BATCH_HPP
+#define PAWNTIFICATE_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "pawntificate/board.hpp"
+#include "pawntificate/evaluate.hpp"
+#include "pawntificate/pawns.hpp"
+
+namespace pawntificate {
+
+// scoring many positions at once, for offline work over stored positions. the
+// threads and everything they use are set up once per call rather than once
+// per position. a thread count of zero uses every core.
+
+// the terms of the static evaluation of many positions, column by column, so
+// that they can be scored in one vectorised pass.
+struct evaluation_columns {
+  std::vector<std::int32_t> mg;
+  std::vector<std::int32_t> eg;
+  std::vector<std::int32_t> phase;
+
+  // 1 when it is white to move, -1 for black.
+  std::vector<std::int32_t> sign;
+
+  auto size() const -> std::size_t {
+    return sign.size();
+  }
+
+  auto resize(std::size_t n) -> void;
+};
+
+// fill the columns with the terms of each board, including its pawn structure
+// which is looked up in pawns.
+auto gather(std::span<const board> boards, pawn_table &pawns, evaluation_columns &columns) -> void;
+
+// the static evaluation of each position in the columns, in centipawns from the
+// point of view of the side to move. the same as evaluate_position.
+auto evaluate_columns(const evaluation_columns &columns, std::span<score> scores) -> void;
+
+// the static evaluation of each board.
+auto evaluate_positions(std::span<const board> boards, std::span<score> scores, std::size_t threads = 0) -> void;
+
+// the score of a search of each board to a fixed depth, from the point of view
+// of the side to move. each thread searches with its own engine, which keeps
+// its transposition table from one position to the next, so the scores can
+// depend on the order the positions are searched in.
+auto search_positions(std::span<const board> boards,
+                      std::size_t depth,
+                      std::span<score> scores,
+                      std::size_t threads = 0) -> void;
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_BATCH_HPP
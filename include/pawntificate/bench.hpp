@@ -0,0 +1,59 @@
+#ifndef PAWNTIFICATE_BENCH_HPP
+#define PAWNTIFICATE_BENCH_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+#include "pawntificate/engine.hpp"
+
+namespace pawntificate {
+
+// a fixed set of searches for measuring the speed of the engine. the total
+// number of nodes is a signature of the search: with a single thread it only
+// changes when the search or evaluation does, so a change that is only meant to
+// be faster can be checked against it.
+constexpr std::size_t default_bench_depth = 6ul;
+
+// openings, middlegames with tactics in them, and endgames.
+constexpr std::array<std::string_view, 14> bench_positions{
+  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+  "r1b1k2r/ppppnppp/2n2q2/2b5/3NP3/2P1B3/PP3PPP/RN1QKB1R w KQkq - 0 1",
+  "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+  "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+  "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+  "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+  "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+  "5rk1/1ppb3p/p1pb4/6q1/3P1p1r/2P1R2P/PP1BQ1P1/5RKN w - - 0 1",
+  "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/3N4 b - - 0 1",
+  "3b4/5kp1/1p1p1p1p/pP1PpP1P/P1P1P3/3KN3/8/8 w - - 0 1",
+  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+  "8/k7/3p4/p2P1p2/P2P1P2/8/8/K7 w - - 0 1",
+  "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1"
+};
+
+struct bench_result {
+  std::uint64_t nodes = 0;
+  std::chrono::milliseconds time{};
+
+  auto nps() const -> std::uint64_t {
+    const auto ms = static_cast<std::uint64_t>(time.count());
+    return nodes * 1000 / (ms == 0 ? 1 : ms);
+  }
+};
+
+// search each of the bench positions to the given depth with the engine as it
+// has been set up. every position starts from an empty transposition table and
+// the same random numbers, so it doesn't matter what was searched before it.
+// on_position is called with the index and result of each search.
+auto bench(engine &e,
+           std::size_t depth = default_bench_depth,
+           const std::function<void(std::size_t, const search_result &)> &on_position = {}) -> bench_result;
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_BENCH_HPP
@@ -7,6 +7,10 @@
 #include <vector>
 
 #include "cxx/make_array.hpp"
+#include "cxx/static_vector.hpp"
+
+#include "pawntificate/psqt.hpp"
+#include "pawntificate/zobrist.hpp"
 
 namespace pawntificate {
 
@@ -320,6 +324,17 @@ public:
     return (data >> 15) == 1;
   }
 
+  // the raw 16-bit encoding, for packing a move into other structures.
+  constexpr auto bits() const -> std::uint16_t {
+    return data;
+  }
+
+  static constexpr auto from_bits(const std::uint16_t bits) -> move {
+    move m;
+    m.data = bits;
+    return m;
+  }
+
 private:
   friend constexpr auto operator==(const move &lhs, const move &rhs) -> bool;
 
@@ -422,6 +437,29 @@ auto operator<<(std::ostream &os, const castle c) -> std::ostream & {
   return os;
 }
 
+// the zobrist keys for each component of a position.
+constexpr auto piece_key(const square s, const piece p) -> std::uint64_t {
+  return zobrist::keys.pieces[p.opcode][static_cast<std::size_t>(s)];
+}
+
+// only pawns contribute to the pawn hash, it is the same for any positions with
+// the same pawn structure.
+constexpr auto pawn_key(const square s, const piece p) -> std::uint64_t {
+  return is_pawn(p) ? piece_key(s, p) : 0ull;
+}
+
+constexpr auto castling_key(const castle c) -> std::uint64_t {
+  return zobrist::keys.castling[static_cast<std::size_t>(c)];
+}
+
+constexpr auto en_passant_key(const square s) -> std::uint64_t {
+  return s == square::_ ? 0ull : zobrist::keys.en_passant[file(s)];
+}
+
+constexpr auto active_key(const colour c) -> std::uint64_t {
+  return c == colour::black ? zobrist::keys.black_to_move : 0ull;
+}
+
 struct board {
   // creates a board with the standard chess start position.
   constexpr board() = default;
@@ -443,6 +481,13 @@ struct board {
 
   // create a board from a list of UCI moves.
   explicit constexpr board(const std::string_view move_list) {
+    play(move_list, [](const board &) {});
+  }
+
+  // play a list of UCI moves, on_move is called with each position before its
+  // move is made.
+  template <typename F>
+  constexpr auto play(const std::string_view move_list, F &&on_move) -> void {
     // move_list will have the format like: a1a2 b2b4 c5d6 a7a8q (promotion).
     // we don't do any error checking of the format for performance reasons.
     const auto end{std::end(move_list)};
@@ -457,6 +502,7 @@ struct board {
         promotion = to_promoted_type(*c++);
       }
 
+      on_move(*this);
       make_move(from, to, promotion);
 
       if (c != std::end(move_list)) {
@@ -467,9 +513,19 @@ struct board {
 
   constexpr auto make_move(const square from, const square to, const ptype promotion) -> void {
     const auto set_square = [this](const square s, const piece p) {
-      piece_board[static_cast<std::size_t>(s)] = p;
+      const auto i = static_cast<std::size_t>(s);
+      auto &current = piece_board[i];
+      hash ^= piece_key(s, current) ^ piece_key(s, p);
+      pawn_hash ^= pawn_key(s, current) ^ pawn_key(s, p);
+      psq.remove(current.opcode, i);
+      psq.add(p.opcode, i);
+      current = p;
     };
 
+    // the castling rights and en passant square are rehashed once they've
+    // been updated for this move.
+    hash ^= castling_key(castling) ^ en_passant_key(en_passant);
+
     // if a king just moved that side can no longer castle either way. if a
     // rook moved castling to that side of the board is no longer valid. same
     // logic applies if their squares were moved into (ie they got captured).
@@ -502,11 +558,17 @@ struct board {
     update_castling_rights(from);
     update_castling_rights(to);
 
-    auto &from_square = piece_board[std::size_t(from)];
-    auto &to_square = piece_board[std::size_t(to)];
+    const auto from_square = piece_board[std::size_t(from)];
 
     const bool is_king = from_square.type() == ptype::king;
 
+    // captures and pawn moves can never be undone so reset the fifty move rule.
+    const bool irreversible = is_pawn(from_square) || piece_board[std::size_t(to)] != pieces::_;
+    halfmove = irreversible ? 0 : static_cast<std::uint16_t>(halfmove + 1);
+    if (active == colour::black) {
+      ++fullmove;
+    }
+
     // is this a castling move?
     if (is_king && from == square::e1 && to == square::g1) {
       // white castle short
@@ -551,12 +613,47 @@ struct board {
         en_passant = square::_;
       }
 
-      to_square = p;
-      from_square = pieces::_;
+      set_square(to, p);
+      set_square(from, pieces::_);
     }
 
-
+    hash ^= castling_key(castling) ^ en_passant_key(en_passant);
+    hash ^= active_key(active);
     flip_colour(active);
+    hash ^= active_key(active);
+  }
+
+  // recalculate the zobrist hash of the position from scratch.
+  constexpr auto compute_hash() const -> std::uint64_t {
+    std::uint64_t h = castling_key(castling) ^ en_passant_key(en_passant) ^ active_key(active);
+    for (unsigned i = 0; i < piece_board.size(); ++i) {
+      h ^= piece_key(static_cast<square>(i), piece_board[i]);
+    }
+
+    return h;
+  }
+
+  // recalculate the zobrist hash of just the pawns from scratch.
+  constexpr auto compute_pawn_hash() const -> std::uint64_t {
+    std::uint64_t h = 0;
+    for (unsigned i = 0; i < piece_board.size(); ++i) {
+      h ^= pawn_key(static_cast<square>(i), piece_board[i]);
+    }
+
+    return h;
+  }
+
+  // recalculate the piece-square totals of the position from scratch, with the
+  // given weights. the totals of the boards made from this one by making moves
+  // keep using them.
+  constexpr auto compute_psq(const psqt::weight_table &w = psqt::weights) const -> psqt::totals {
+    psqt::totals t;
+    t.table = &w;
+    for (unsigned i = 0; i < piece_board.size(); ++i) {
+      t.add(piece_board[i].opcode, i);
+    }
+
+    return t;
   }
 
   constexpr auto make_move(const move m) -> void {
@@ -567,6 +664,13 @@ struct board {
   castle castling = castle::all;
   square en_passant = square::_;
 
+  // plies since the last capture or pawn move, for the fifty move rule.
+  std::uint16_t halfmove = 0;
+
+  // the number of the move being played, starting from one and going up after
+  // each of black's moves.
+  std::uint16_t fullmove = 1;
+
   // an internal representation of the chess board where each square is an index
   // into this array. white at the top of the board.
   // TODO: can make this half the size by packing pieces together.
@@ -584,6 +688,13 @@ struct board {
       r, n, b, q, k, b, n, r
     );
   }();
+
+  // zobrist hash of the position and the running totals for the evaluation,
+  // these must be declared after the rest of the state as they are derived
+  // from it.
+  std::uint64_t hash = compute_hash();
+  std::uint64_t pawn_hash = compute_pawn_hash();
+  psqt::totals psq = compute_psq();
 };
 
 constexpr auto operator==(const board &lhs, const board &rhs) -> bool {
@@ -607,9 +718,34 @@ auto operator<<(std::ostream &os, const board &b) -> std::ostream & {
   return os << ' ' << b.active << ' ' << b.castling << ' '<< b.en_passant;
 }
 
+// no position has more legal moves than this (the most known is 218).
+constexpr std::size_t max_moves = 256ul;
+using move_list = cxx::static_vector<move, max_moves>;
+
 // given a board, list all of the legal moves available.
 auto find_legal_moves(const board &b) -> std::vector<move>;
 
+// as above but into a buffer that the caller owns, so it never allocates. any
+// moves already in the buffer are replaced.
+auto find_legal_moves(const board &b, move_list &moves) -> void;
+
+// is the king of the side to move under attack.
+auto in_check(const board &b) -> bool;
+
+// write a legal move in standard algebraic notation, as used by PGN and EPD:
+// the piece, just enough of the square it came from to tell it apart from the
+// others that could go to the same square, whether it captures, where it goes
+// and any promotion, followed by + for check or # for mate.
+auto to_san(std::ostream &os, const board &b, move m) -> std::ostream &;
+
+// set up a board from the fields of a FEN string: the piece placement, the side
+// to move, castling rights, the en passant square and optionally the halfmove
+// and fullmove counters. anything after those is ignored, so EPD lines can be
+// read too. false if the fields are malformed or either side doesn't have
+// exactly one king, in which case b is left unchanged. it never allocates, so
+// it can be given a view straight into a command or a mapped file.
+auto parse_fen(std::string_view fen, board &b) -> bool;
+
 } // namespace pawntificate
 
 #endif // PAWNTIFICATE_BOARD_HPP
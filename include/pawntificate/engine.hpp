@@ -0,0 +1,299 @@
+#ifndef PAWNTIFICATE_ENGINE_HPP
+#define PAWNTIFICATE_ENGINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "cxx/static_vector.hpp"
+#include "cxx/work_stealing_pool.hpp"
+
+#include "pawntificate/board.hpp"
+#include "pawntificate/eval_cache.hpp"
+#include "pawntificate/evaluate.hpp"
+#include "pawntificate/key_history.hpp"
+#include "pawntificate/nnue.hpp"
+#include "pawntificate/psqt.hpp"
+#include "pawntificate/transposition_table.hpp"
+
+namespace pawntificate {
+
+// size of the transposition table in megabytes.
+constexpr std::size_t default_hash_size = 16ul;
+constexpr std::size_t max_threads = 256ul;
+constexpr std::size_t max_depth = 64ul;
+
+// what the search is allowed to spend on a move.
+struct search_limits {
+  std::size_t depth = max_depth;
+
+  // the time left on each player's clock and their increment per move. if
+  // neither clock is set the search is only limited by depth.
+  std::chrono::milliseconds wtime{0};
+  std::chrono::milliseconds btime{0};
+  std::chrono::milliseconds winc{0};
+  std::chrono::milliseconds binc{0};
+  std::size_t movestogo = 0;
+
+  // a fixed time to search for, and a budget of nodes summed over every
+  // thread. zero for no limit.
+  std::chrono::milliseconds movetime{0};
+  std::uint64_t nodes = 0;
+
+  // look for a mate in this many moves, which limits the depth to what is
+  // needed to find one. zero for no limit.
+  std::size_t mate = 0;
+
+  // only search these moves at the root, all of them if it is empty.
+  move_list searchmoves;
+
+  // search the opponent's time, the clock doesn't start until ponderhit.
+  bool ponder = false;
+
+  // keep going until told to stop, the result isn't given before then even if
+  // the search finishes.
+  bool infinite = false;
+
+  auto timed() const -> bool {
+    return wtime.count() > 0 || btime.count() > 0;
+  }
+};
+
+// the time budget of a search, which doesn't start counting down until
+// pondering has finished.
+class search_clock {
+public:
+  // a budget of zero means there is no time limit.
+  auto reset(std::chrono::milliseconds budget, bool ponder) -> void;
+  auto ponderhit() -> void;
+
+  // true once more than the given fraction of the budget has been used.
+  auto expired(double fraction = 1.0) const -> bool;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  std::atomic<bool> pondering{false};
+  std::atomic<clock::rep> start{0};
+  std::atomic<clock::rep> budget{0};
+};
+
+// how the work of a search is split between threads.
+enum class parallel_search {
+  // every thread searches the whole tree, sharing the transposition table.
+  shared_hash,
+
+  // young brothers wait: the moves of a node are shared out between the threads
+  // once its first move has been searched.
+  tree_split
+};
+
+// how the leaves of the search are scored.
+enum class evaluator {
+  // the tapered piece-square tables, see psqt.hpp.
+  psqt,
+
+  // a network loaded with engine::load_network, see nnue.hpp. falls back to
+  // the piece-square tables until one has been loaded.
+  nnue
+};
+
+struct principal_variation {
+  score value = 0;
+  cxx::static_vector<move, max_depth> moves;
+};
+
+struct search_result {
+  move best;
+  score value = 0;
+
+  // the best lines found, strongest first. there is one per multi pv.
+  std::vector<principal_variation> lines;
+
+  // the deepest iteration the main thread completed.
+  std::size_t depth = 0;
+
+  // summed over all of the search threads, the leaves that were found in the
+  // evaluation cache and those that had to be evaluated.
+  std::uint64_t nodes = 0;
+  std::uint64_t eval_hits = 0;
+  std::uint64_t eval_misses = 0;
+  std::chrono::milliseconds time{};
+
+  auto nps() const -> std::uint64_t {
+    const auto ms = static_cast<std::uint64_t>(time.count());
+    return nodes * 1000 / (ms == 0 ? 1 : ms);
+  }
+};
+
+// how far a running search has got, reported from the search thread.
+struct search_info {
+  // the iteration being searched, and the deepest leaf it has reached.
+  std::size_t depth = 0;
+  std::size_t seldepth = 0;
+
+  // summed over all of the search threads, the helpers only add their nodes to
+  // the total every so often so it is a little behind.
+  std::uint64_t nodes = 0;
+  std::chrono::milliseconds time{};
+
+  // the best lines of an iteration once it has completed, strongest first,
+  // along with how full the transposition table is in parts per thousand.
+  // empty while the iteration is still running.
+  std::span<const principal_variation> lines;
+  std::size_t hashfull = 0;
+
+  // the root move that is about to be searched and its number, from 1. only
+  // set while the iteration is running.
+  move currmove;
+  std::size_t currmovenumber = 0;
+
+  auto nps() const -> std::uint64_t {
+    const auto ms = static_cast<std::uint64_t>(time.count());
+    return nodes * 1000 / (ms == 0 ? 1 : ms);
+  }
+};
+
+// a search thread's own state, see engine.cpp.
+struct search_worker;
+
+// the search state that persists between moves of a game. the threads and
+// everything they search with are only allocated when the number of threads
+// changes, searching itself never allocates.
+class engine {
+public:
+  engine();
+
+  // search with a table that is shared with other engines, which may be
+  // searching at the same time. it must outlive the engine, and is only resized
+  // or cleared while none of them are searching. the searches don't start a new
+  // generation of its entries, that is up to its owner.
+  explicit engine(transposition_table &shared);
+  ~engine();
+
+  engine(const engine &) = delete;
+  auto operator=(const engine &) -> engine & = delete;
+
+  // the settings, and anything that resizes or clears the transposition table,
+  // wait for the running search to finish first. a shared table must also not
+  // be in use by any of the other engines.
+  auto set_threads(std::size_t n) -> void;
+  auto set_parallel_search(parallel_search p) -> void;
+
+  // the number of best lines to find, rather than just the best move.
+  auto set_multi_pv(std::size_t n) -> void;
+  auto set_hash_size(std::size_t megabytes) -> void;
+
+  // any of these throws away the cached evaluations.
+  auto set_evaluator(evaluator e) -> void;
+
+  // map the weights of a network from a file, false if it couldn't be loaded.
+  // the previous network is dropped either way.
+  auto load_network(const std::filesystem::path &path) -> bool;
+
+  // evaluate with piece-square parameters read from a file, as written by
+  // psqt::save_parameters. false if it couldn't be loaded, in which case the
+  // current parameters are kept. they only apply to this engine's searches.
+  auto load_parameters(const std::filesystem::path &path) -> bool;
+
+  // called from the search thread as each root move is started and whenever an
+  // iteration completes, it should return quickly as the search waits for it.
+  auto set_info_handler(std::function<void(const search_info &)> on_info) -> void;
+
+  // forget everything that was learnt about the positions of the last game.
+  auto new_game() -> void;
+
+  // start an iterative deepening search of the board on a background thread,
+  // using as many threads as have been set. game holds the positions before
+  // this one, for detecting repetitions. on_finish is called from the search
+  // thread with the result once it is done. a pondering search holds on to its
+  // result until either ponderhit or stop, an infinite one until stop.
+  auto start(const board &b,
+             const key_history &game,
+             const search_limits &limits,
+             std::mt19937 &gen,
+             std::function<void(const search_result &)> on_finish) -> void;
+
+  // ask the running search to finish as soon as possible, the result will be
+  // from the last iteration it completed.
+  auto stop() -> void;
+
+  // the opponent played the move we were pondering on: carry on with the same
+  // search, but as a normal timed one starting from now.
+  auto ponderhit() -> void;
+
+  // block until the running search has finished.
+  auto wait() -> void;
+
+  // start a search and wait for it to finish.
+  auto search(const board &b, std::size_t depth, std::mt19937 &gen) -> search_result;
+
+private:
+  // what start has asked the search thread to do.
+  struct job {
+    board b;
+    key_history game;
+    search_limits limits;
+    std::mt19937 *gen = nullptr;
+    std::function<void(const search_result &)> on_finish;
+  };
+
+  auto idle_loop() -> void;
+  auto run() -> void;
+
+  std::size_t threads = 1;
+  parallel_search parallelism = parallel_search::shared_hash;
+  std::size_t multi_pv = 1;
+  evaluator eval = evaluator::psqt;
+  nnue::network network;
+
+  // the piece-square weights the searches evaluate with.
+  psqt::weight_table weights = psqt::weights;
+
+  // the engine's own table, unless it was given one to share.
+  std::unique_ptr<transposition_table> own_tt;
+  transposition_table &tt;
+  eval_cache evals;
+
+  std::atomic<bool> stop_flag{false};
+  search_clock clock;
+  std::function<void(const search_info &)> on_info;
+
+  // the nodes the helpers have searched so far, added to as they go.
+  std::atomic<std::uint64_t> searched{0};
+
+  // one per thread, the first belongs to the search thread and the rest to the
+  // threads of the pool.
+  std::vector<search_worker> workers;
+  std::unique_ptr<cxx::work_stealing_pool> pool;
+
+  // the search thread waits here for the next job between searches.
+  std::thread search_thread;
+  std::mutex job_lock;
+  std::condition_variable job_ready;
+  std::condition_variable job_done;
+  job next;
+  bool busy = false;
+  bool quit = false;
+
+  // guards the hand over of a pondering or infinite search's result.
+  std::mutex ponder_lock;
+  std::condition_variable ponder_end;
+  bool pondering = false;
+  bool infinite = false;
+  bool stop_requested = false;
+};
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_ENGINE_HPP
@@ -0,0 +1,36 @@
+#ifndef PAWNTIFICATE_EVAL_CACHE_HPP
+#define PAWNTIFICATE_EVAL_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "pawntificate/evaluate.hpp"
+
+namespace pawntificate {
+
+// size of the evaluation cache in megabytes.
+constexpr std::size_t default_eval_cache_size = 1ul;
+
+// the static evaluations of recently seen positions, keyed by their zobrist
+// hash and shared between all of the search threads. each slot is a single
+// word holding the top half of the key and the score, so there are no locks and
+// nothing can be torn.
+class eval_cache {
+public:
+  explicit eval_cache(std::size_t megabytes = default_eval_cache_size);
+
+  auto clear() -> void;
+
+  auto probe(std::uint64_t key, score &value) const -> bool;
+  auto store(std::uint64_t key, score value) -> void;
+
+private:
+  std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+  std::size_t mask = 0;
+};
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_EVAL_CACHE_HPP
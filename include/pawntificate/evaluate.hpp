@@ -9,9 +9,27 @@ namespace pawntificate {
 struct board;
 
 class move;
+class pawn_table;
+
+using score = int;
+
+// a forced mate scores mate minus the number of plies until it happens, so that
+// shorter mates are preferred. anything beyond mate_bound is a mate score.
+constexpr score mate = 32000;
+constexpr score mate_bound = mate - 256;
+
+constexpr auto is_mate(const score s) -> bool {
+  return s >= mate_bound || s <= -mate_bound;
+}
 
 constexpr std::size_t default_depth = 7ul;
 
+// the static evaluation of a board in centipawns, from the point of view of the
+// side to move. the pawn structure terms are looked up in pawns, or worked out
+// from scratch without it.
+auto evaluate_position(const board &b) -> score;
+auto evaluate_position(const board &b, pawn_table &pawns) -> score;
+
 // for a given board, return the strongest move in UCI format.
 auto evaluate(const board &b, std::size_t depth = default_depth) -> move;
 auto evaluate(const board &b, std::mt19937 &rng, std::size_t depth = default_depth) -> move;
@@ -0,0 +1,66 @@
+#ifndef PAWNTIFICATE_KEY_HISTORY_HPP
+#define PAWNTIFICATE_KEY_HISTORY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pawntificate {
+
+// the zobrist keys of the positions leading up to the current one, oldest
+// first. only the positions since the last irreversible move can repeat, so
+// once full the oldest keys are dropped rather than growing.
+class key_history {
+public:
+  static constexpr std::size_t capacity = 256ul;
+
+  constexpr key_history() = default;
+
+  constexpr auto push(const std::uint64_t key) -> void {
+    if (n == capacity) {
+      std::copy(std::begin(keys) + capacity / 2, std::end(keys), std::begin(keys));
+      n -= capacity / 2;
+    }
+
+    keys[n++] = key;
+  }
+
+  constexpr auto pop() -> void {
+    --n;
+  }
+
+  constexpr auto clear() -> void {
+    n = 0;
+  }
+
+  constexpr auto size() const -> std::size_t {
+    return n;
+  }
+
+  constexpr auto back() const -> std::uint64_t {
+    return keys[n - 1];
+  }
+
+  // true if the position has occurred before in the last halfmove plies, ie.
+  // since the last capture or pawn move. a position can only repeat with the
+  // same side to move and at least four plies later.
+  constexpr auto is_repetition(const std::uint64_t key, const std::size_t halfmove) const -> bool {
+    const auto end = std::min(halfmove, n);
+    for (auto i = 4ul; i <= end; i += 2) {
+      if (keys[n - i] == key) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+private:
+  std::array<std::uint64_t, capacity> keys{};
+  std::size_t n = 0;
+};
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_KEY_HISTORY_HPP
@@ -0,0 +1,98 @@
+#ifndef PAWNTIFICATE_NNUE_HPP
+#define PAWNTIFICATE_NNUE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "pawntificate/board.hpp"
+#include "pawntificate/evaluate.hpp"
+
+namespace pawntificate {
+namespace nnue {
+
+// the shape of the network. the input features are halfkp: for each side, the
+// square of its own king paired with every other piece (kings aside) and its
+// square. these go through a feature transformer of half_dimensions per side,
+// then two hidden layers and a single output.
+constexpr std::size_t feature_count = 64ul * 10ul * 64ul;
+constexpr std::size_t half_dimensions = 256ul;
+constexpr std::size_t hidden_dimensions = 32ul;
+
+// a network file is little endian, made of these sections in this order with
+// nothing in between:
+//   header           header_size bytes: the magic, then version, half_dimensions
+//                    and hidden_dimensions as uint32, zero padded.
+//   feature biases   int16[half_dimensions]
+//   feature weights  int16[feature_count][half_dimensions]
+//   hidden1 biases   int32[hidden_dimensions]
+//   hidden1 weights  int8[hidden_dimensions][2 * half_dimensions]
+//   hidden2 biases   int32[hidden_dimensions]
+//   hidden2 weights  int8[hidden_dimensions][hidden_dimensions]
+//   output bias      int32
+//   output weights   int8[hidden_dimensions]
+constexpr std::array<char, 4> magic{'p', 'w', 'n', 'n'};
+constexpr std::uint32_t version = 1u;
+constexpr std::size_t header_size = 64ul;
+constexpr std::size_t file_size = header_size +
+  half_dimensions * 2 +
+  feature_count * half_dimensions * 2 +
+  hidden_dimensions * 4 + hidden_dimensions * 2 * half_dimensions +
+  hidden_dimensions * 4 + hidden_dimensions * hidden_dimensions +
+  4 + hidden_dimensions;
+
+// the output of the feature transformer from each side's point of view,
+// indexed by colour. an accumulator belongs to a position, they are copied
+// forward from move to move so unmaking a move is just going back to the
+// previous position's.
+struct accumulator {
+  alignas(32) std::array<std::array<std::int16_t, half_dimensions>, 2> values;
+};
+
+// the weights of a network, mapped read only from a file.
+class network {
+public:
+  network() = default;
+  ~network();
+
+  network(const network &) = delete;
+  auto operator=(const network &) -> network & = delete;
+
+  // false if the file can't be mapped or isn't a network of this shape, in
+  // which case the network is left empty.
+  auto load(const std::filesystem::path &path) -> bool;
+  auto loaded() const -> bool;
+
+  // compute the accumulator of a position from scratch.
+  auto refresh(const board &b, accumulator &acc) const -> void;
+
+  // compute the accumulator of child, a position one move on from parent, by
+  // only adding and removing the features of the squares that changed. a
+  // side whose king moved is refreshed instead.
+  auto update(const board &parent, const accumulator &from, const board &child, accumulator &to) const -> void;
+
+  // the evaluation of a position in centipawns from the point of view of the
+  // side to move.
+  auto evaluate(const board &b, const accumulator &acc) const -> score;
+
+private:
+  auto unmap() -> void;
+  auto refresh(const board &b, colour perspective, accumulator &acc) const -> void;
+
+  void *mapping = nullptr;
+
+  const std::int16_t *feature_biases = nullptr;
+  const std::int16_t *feature_weights = nullptr;
+  const std::int32_t *hidden1_biases = nullptr;
+  const std::int8_t *hidden1_weights = nullptr;
+  const std::int32_t *hidden2_biases = nullptr;
+  const std::int8_t *hidden2_weights = nullptr;
+  const std::int32_t *output_bias = nullptr;
+  const std::int8_t *output_weights = nullptr;
+};
+
+} // namespace nnue
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_NNUE_HPP
@@ -0,0 +1,62 @@
+#ifndef PAWNTIFICATE_PAWNS_HPP
+#define PAWNTIFICATE_PAWNS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "pawntificate/board.hpp"
+
+namespace pawntificate {
+
+// number of entries in each thread's pawn hash table.
+constexpr std::size_t default_pawn_entries = 1ul << 14u;
+
+// the pawn structure terms of a position, which only depend on where the pawns
+// are: passed, isolated, doubled and backward pawns.
+struct pawn_entry {
+  std::uint64_t key = 0;
+
+  // in centipawns from white's point of view, blended between the phases along
+  // with the piece-square tables.
+  std::int32_t mg = 0;
+  std::int32_t eg = 0;
+
+  // a bit per square of each side's passed pawns, indexed by colour.
+  std::array<std::uint64_t, 2> passed{};
+};
+
+// work out the pawn structure terms from scratch.
+auto evaluate_pawns(const board &b) -> pawn_entry;
+
+// the pawn terms of recently seen pawn structures, keyed by the board's pawn
+// hash. the pawns hardly change within a search, so almost every lookup is a
+// hit. each search thread has its own, so they aren't synchronised.
+class pawn_table {
+public:
+  explicit pawn_table(std::size_t size = default_pawn_entries);
+
+  // the entry for the board's pawn structure, evaluated and stored if it isn't
+  // already in the table.
+  auto probe(const board &b) -> const pawn_entry &;
+  auto clear() -> void;
+
+  auto hits() const -> std::uint64_t {
+    return hit_count;
+  }
+
+  auto misses() const -> std::uint64_t {
+    return miss_count;
+  }
+
+private:
+  std::size_t mask;
+  std::unique_ptr<pawn_entry[]> entries;
+  std::uint64_t hit_count = 0;
+  std::uint64_t miss_count = 0;
+};
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_PAWNS_HPP
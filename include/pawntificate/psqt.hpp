@@ -0,0 +1,267 @@
+#ifndef PAWNTIFICATE_PSQT_HPP
+#define PAWNTIFICATE_PSQT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace pawntificate {
+namespace psqt {
+
+// material and piece-square tables for the middlegame and the endgame, in
+// centipawns. these are the PeSTO tables, written from white's point of view
+// with the eighth rank first as they are usually printed.
+using raw_table = std::array<std::int16_t, 64>;
+
+// indexed by piece type: none, pawn, knight, bishop, rook, queen, king.
+constexpr std::array<std::int16_t, 7> mg_value{0, 82, 337, 365, 477, 1025, 0};
+constexpr std::array<std::int16_t, 7> eg_value{0, 94, 281, 297, 512, 936, 0};
+
+// how much each piece type counts towards the middlegame, the starting
+// position has max_phase.
+constexpr std::array<std::int32_t, 7> phase_weight{0, 0, 1, 1, 2, 4, 0};
+constexpr std::int32_t max_phase = 24;
+
+constexpr std::array<raw_table, 7> mg_raw{{
+  {},
+  {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     98, 134,  61,  95,  68, 126,  34, -11,
+     -6,   7,  26,  31,  65,  56,  25, -20,
+    -14,  13,   6,  21,  23,  12,  17, -23,
+    -27,  -2,  -5,  12,  17,   6,  10, -25,
+    -26,  -4,  -4, -10,   3,   3,  33, -12,
+    -35,  -1, -20, -23, -15,  24,  38, -22,
+      0,   0,   0,   0,   0,   0,   0,   0
+  },
+  {
+   -167, -89, -34, -49,  61, -97, -15,-107,
+    -73, -41,  72,  36,  23,  62,   7, -17,
+    -47,  60,  37,  65,  84, 129,  73,  44,
+     -9,  17,  19,  53,  37,  69,  18,  22,
+    -13,   4,  16,  13,  28,  19,  21,  -8,
+    -23,  -9,  12,  10,  19,  17,  25, -16,
+    -29, -53, -12,  -3,  -1,  18, -14, -19,
+   -105, -21, -58, -33, -17, -28, -19, -23
+  },
+  {
+    -29,   4, -82, -37, -25, -42,   7,  -8,
+    -26,  16, -18, -13,  30,  59,  18, -47,
+    -16,  37,  43,  40,  35,  50,  37,  -2,
+     -4,   5,  19,  50,  37,  37,   7,  -2,
+     -6,  13,  13,  26,  34,  12,  10,   4,
+      0,  15,  15,  15,  14,  27,  18,  10,
+      4,  15,  16,   0,   7,  21,  33,   1,
+    -33,  -3, -14, -21, -13, -12, -39, -21
+  },
+  {
+     32,  42,  32,  51,  63,   9,  31,  43,
+     27,  32,  58,  62,  80,  67,  26,  44,
+     -5,  19,  26,  36,  17,  45,  61,  16,
+    -24, -11,   7,  26,  24,  35,  -8, -20,
+    -36, -26, -12,  -1,   9,  -7,   6, -23,
+    -45, -25, -16, -17,   3,   0,  -5, -33,
+    -44, -16, -20,  -9,  -1,  11,  -6, -71,
+    -19, -13,   1,  17,  16,   7, -37, -26
+  },
+  {
+    -28,   0,  29,  12,  59,  44,  43,  45,
+    -24, -39,  -5,   1, -16,  57,  28,  54,
+    -13, -17,   7,   8,  29,  56,  47,  57,
+    -27, -27, -16, -16,  -1,  17,  -2,   1,
+     -9, -26,  -9, -10,  -2,  -4,   3,  -3,
+    -14,   2, -11,  -2,  -5,   2,  14,   5,
+    -35,  -8,  11,   2,   8,  15,  -3,   1,
+     -1, -18,  -9,  10, -15, -25, -31, -50
+  },
+  {
+    -65,  23,  16, -15, -56, -34,   2,  13,
+     29,  -1, -20,  -7,  -8,  -4, -38, -29,
+     -9,  24,   2, -16, -20,   6,  22, -22,
+    -17, -20, -12, -27, -30, -25, -14, -36,
+    -49,  -1, -27, -39, -46, -44, -33, -51,
+    -14, -14, -22, -46, -44, -30, -15, -27,
+      1,   7,  -8, -64, -43, -16,   9,   8,
+    -15,  36,  12, -54,   8, -28,  24,  14
+  }
+}};
+
+constexpr std::array<raw_table, 7> eg_raw{{
+  {},
+  {
+      0,   0,   0,   0,   0,   0,   0,   0,
+    178, 173, 158, 134, 147, 132, 165, 187,
+     94, 100,  85,  67,  56,  53,  82,  84,
+     32,  24,  13,   5,  -2,   4,  17,  17,
+     13,   9,  -3,  -7,  -7,  -8,   3,  -1,
+      4,   7,  -6,   1,   0,  -5,  -1,  -8,
+     13,   8,   8,  10,  13,   0,   2,  -7,
+      0,   0,   0,   0,   0,   0,   0,   0
+  },
+  {
+    -58, -38, -13, -28, -31, -27, -63, -99,
+    -25,  -8, -25,  -2,  -9, -25, -24, -52,
+    -24, -20,  10,   9,  -1,  -9, -19, -41,
+    -17,   3,  22,  22,  22,  11,   8, -18,
+    -18,  -6,  16,  25,  16,  17,   4, -18,
+    -23,  -3,  -1,  15,  10,  -3, -20, -22,
+    -42, -20, -10,  -5,  -2, -20, -23, -44,
+    -29, -51, -23, -15, -22, -18, -50, -64
+  },
+  {
+    -14, -21, -11,  -8,  -7,  -9, -17, -24,
+     -8,  -4,   7, -12,  -3, -13,  -4, -14,
+      2,  -8,   0,  -1,  -2,   6,   0,   4,
+     -3,   9,  12,   9,  14,  10,   3,   2,
+     -6,   3,  13,  19,   7,  10,  -3,  -9,
+    -12,  -3,   8,  10,  13,   3,  -7, -15,
+    -14, -18,  -7,  -1,   4,  -9, -15, -27,
+    -23,  -9, -23,  -5,  -9, -16,  -5, -17
+  },
+  {
+     13,  10,  18,  15,  12,  12,   8,   5,
+     11,  13,  13,  11,  -3,   3,   8,   3,
+      7,   7,   7,   5,   4,  -3,  -5,  -3,
+      4,   3,  13,   1,   2,   1,  -1,   2,
+      3,   5,   8,   4,  -5,  -6,  -8, -11,
+     -4,   0,  -5,  -1,  -7, -12,  -8, -16,
+     -6,  -6,   0,   2,  -9,  -9, -11,  -3,
+     -9,   2,   3,  -1,  -5, -13,   4, -20
+  },
+  {
+     -9,  22,  22,  27,  27,  19,  10,  20,
+    -17,  20,  32,  41,  58,  25,  30,   0,
+    -20,   6,   9,  49,  47,  35,  19,   9,
+      3,  22,  24,  45,  57,  40,  57,  36,
+    -18,  28,  19,  47,  31,  34,  39,  23,
+    -16, -27,  15,   6,   9,  17,  10,   5,
+    -22, -23, -30, -16, -16, -23, -36, -32,
+    -33, -28, -22, -43,  -5, -32, -20, -41
+  },
+  {
+    -74, -35, -18, -18, -11,  15,   4, -17,
+    -12,  17,  14,  17,  17,  38,  23,  11,
+     10,  17,  23,  15,  20,  45,  44,  13,
+     -8,  22,  24,  27,  26,  33,  26,   3,
+    -18,  -4,  21,  24,  27,  23,   9, -11,
+    -19,  -3,  11,  21,  23,  16,   7,  -9,
+    -27, -11,   4,  13,  14,   4,  -5, -17,
+    -53, -34, -21, -11, -28, -14, -24, -43
+  }
+}};
+
+// everything the tables are built from, which is what gets tuned.
+struct parameters {
+  std::array<std::int16_t, 7> mg_value;
+  std::array<std::int16_t, 7> eg_value;
+  std::array<raw_table, 7> mg_raw;
+  std::array<raw_table, 7> eg_raw;
+};
+
+constexpr parameters defaults{mg_value, eg_value, mg_raw, eg_raw};
+
+struct weight_table {
+  // indexed by piece opcode and then square, the piece's value plus its square
+  // bonus. negative for black so that the totals are from white's point of
+  // view. the null piece is zero so that empty squares don't contribute.
+  std::array<std::array<std::int32_t, 64>, 16> mg{};
+  std::array<std::array<std::int32_t, 64>, 16> eg{};
+  std::array<std::int32_t, 16> phase{};
+};
+
+constexpr auto make_weights(const parameters &params) -> weight_table {
+  weight_table w;
+
+  // opcodes 0 and 1 are the null piece and a white piece with no type.
+  for (unsigned p = 2; p < 14; ++p) {
+    const bool white = (p & 1u) != 0;
+    const auto type = p >> 1u;
+    const auto sign = white ? 1 : -1;
+
+    for (unsigned s = 0; s < 64; ++s) {
+      // the raw tables start from a8, black's are mirrored vertically.
+      const auto i = white ? s ^ 56u : s;
+      w.mg[p][s] = sign * (params.mg_value[type] + params.mg_raw[type][i]);
+      w.eg[p][s] = sign * (params.eg_value[type] + params.eg_raw[type][i]);
+    }
+
+    w.phase[p] = phase_weight[type];
+  }
+
+  return w;
+}
+
+constexpr weight_table weights = make_weights(defaults);
+
+// read and write parameters as text, a line per table: its name followed by
+// its values in the same order as the tables above. false if the file can't be
+// opened or is malformed, in which case params is left unchanged.
+auto load_parameters(const std::filesystem::path &path, parameters &params) -> bool;
+auto save_parameters(const std::filesystem::path &path, const parameters &params) -> bool;
+
+// running totals of the weights of every piece on the board, and the table
+// they are taken from. the table must outlive the totals and every copy of
+// them.
+struct totals {
+  std::int32_t mg = 0;
+  std::int32_t eg = 0;
+  std::int32_t phase = 0;
+  const weight_table *table = &weights;
+
+  constexpr auto add(const std::uint8_t opcode, const std::size_t s) -> void {
+    mg += table->mg[opcode][s];
+    eg += table->eg[opcode][s];
+    phase += table->phase[opcode];
+  }
+
+  constexpr auto remove(const std::uint8_t opcode, const std::size_t s) -> void {
+    mg -= table->mg[opcode][s];
+    eg -= table->eg[opcode][s];
+    phase -= table->phase[opcode];
+  }
+
+  // blend the two phases by how much material is left, from white's point of
+  // view. promotions can take the phase past the start position's.
+  constexpr auto blend() const -> std::int32_t {
+    const auto p = phase < max_phase ? phase : max_phase;
+    return (mg * p + eg * (max_phase - p)) / max_phase;
+  }
+};
+
+constexpr auto operator==(const totals &lhs, const totals &rhs) -> bool {
+  return lhs.mg == rhs.mg && lhs.eg == rhs.eg && lhs.phase == rhs.phase;
+}
+
+// blend many totals at once, given column by column: out[i] is the same as
+// totals::blend of mg[i], eg[i] and phase[i]. written so the compiler
+// vectorises it.
+constexpr auto blend(const std::span<const std::int32_t> mg,
+                     const std::span<const std::int32_t> eg,
+                     const std::span<const std::int32_t> phase,
+                     const std::span<std::int32_t> out) -> void {
+  for (auto i = 0ul; i < out.size(); ++i) {
+    const auto p = phase[i] < max_phase ? phase[i] : max_phase;
+    out[i] = (mg[i] * p + eg[i] * (max_phase - p)) / max_phase;
+  }
+}
+
+// the totals of a fixed number of positions side by side.
+template <std::size_t N>
+struct batch {
+  std::array<std::int32_t, N> mg;
+  std::array<std::int32_t, N> eg;
+  std::array<std::int32_t, N> phase;
+};
+
+// blend the first n totals of a batch.
+template <std::size_t N>
+constexpr auto blend(const batch<N> &b, const std::size_t n, std::array<std::int32_t, N> &out) -> void {
+  blend({b.mg.data(), n}, {b.eg.data(), n}, {b.phase.data(), n}, {out.data(), n});
+}
+
+} // namespace psqt
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_PSQT_HPP
@@ -0,0 +1,31 @@
+#ifndef PAWNTIFICATE_QUIESCE_HPP
+#define PAWNTIFICATE_QUIESCE_HPP
+
+#include "pawntificate/board.hpp"
+#include "pawntificate/evaluate.hpp"
+#include "pawntificate/pawns.hpp"
+
+namespace pawntificate {
+
+// how many captures and promotions deep a quiescence search goes before it
+// settles for the static evaluation.
+constexpr std::size_t max_quiesce_depth = 32ul;
+
+struct quiesce_result {
+  // in centipawns from the point of view of the side to move.
+  score value = 0;
+
+  // the quiet position at the end of the principal variation, the one whose
+  // static evaluation the value comes from.
+  board leaf;
+};
+
+// search only the captures and promotions of a position until it is quiet, so
+// that its score doesn't depend on a piece that is about to be taken. either
+// side may decline to capture and take the static evaluation instead. being
+// mated scores like it does in the main search, a stalemate is zero.
+auto quiesce(const board &b, pawn_table &pawns) -> quiesce_result;
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_QUIESCE_HPP
@@ -0,0 +1,66 @@
+#ifndef PAWNTIFICATE_TRANSPOSITION_TABLE_HPP
+#define PAWNTIFICATE_TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "pawntificate/board.hpp"
+#include "pawntificate/evaluate.hpp"
+
+namespace pawntificate {
+
+// what the stored score says about the true score of the position.
+enum class bound : std::uint8_t {
+  upper, lower, exact
+};
+
+struct transposition {
+  move best;
+  score value = 0;
+  std::uint8_t depth = 0;
+  bound type = bound::exact;
+};
+
+// a fixed size hash table of previously searched positions, shared between all
+// of the search threads. there are no locks: each slot stores its key xor'd with
+// its data so a slot that is torn by two threads writing at once simply fails
+// to match on the next probe.
+class transposition_table {
+public:
+  explicit transposition_table(std::size_t megabytes);
+
+  // resizing throws away all of the existing entries.
+  auto resize(std::size_t megabytes) -> void;
+  auto clear() -> void;
+
+  // called at the start of every search so entries from previous searches are
+  // the first to be replaced.
+  auto new_search() -> void;
+
+  auto probe(std::uint64_t key, transposition &entry) const -> bool;
+  auto store(std::uint64_t key, const transposition &entry) -> void;
+
+  // how full the table is with entries from the current search, in parts per
+  // thousand. estimated from the first thousand slots.
+  auto hashfull() const -> std::size_t;
+
+private:
+  struct slot {
+    std::atomic<std::uint64_t> check;
+    std::atomic<std::uint64_t> data;
+  };
+
+  std::unique_ptr<slot[]> slots;
+  std::size_t mask = 0;
+  auto current_generation() const -> std::uint8_t;
+
+  // engines searching at the same time can share a table, the generation is
+  // moved on by whoever owns it.
+  std::atomic<std::uint8_t> generation{0};
+};
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_TRANSPOSITION_TABLE_HPP
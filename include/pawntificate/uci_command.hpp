@@ -18,6 +18,13 @@ public:
     std::getline(in, cmd);
   }
 
+  // take a line that has already been read, line is left with the previous
+  // command so its buffer can be reused.
+  auto read_line(std::string &line) -> void {
+    n = 0;
+    cmd.swap(line);
+  }
+
   // returns the next token (whitespace deliminated), if there is one.
   auto next_token() -> std::string_view {
     if (n == std::string::npos) {
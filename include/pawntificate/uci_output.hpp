@@ -0,0 +1,82 @@
+#ifndef PAWNTIFICATE_UCI_OUTPUT_HPP
+#define PAWNTIFICATE_UCI_OUTPUT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "pawntificate/board.hpp"
+#include "pawntificate/engine.hpp"
+#include "pawntificate/evaluate.hpp"
+
+namespace pawntificate {
+
+// everything the engine says to the gui. lines are formatted into buffers that
+// are allocated up front and written out on a thread of their own, everything
+// queued since the last write going out in one go. the search thread never
+// waits on the stream, and the progress updates it sends while an iteration
+// is running are limited to one per interval. if the stream falls so far
+// behind that a buffer's worth is waiting, updates are dropped and only the
+// best move waits for room.
+class uci_output {
+public:
+  explicit uci_output(std::ostream &os, std::chrono::milliseconds interval = std::chrono::milliseconds{100});
+  ~uci_output();
+
+  uci_output(const uci_output &) = delete;
+  auto operator=(const uci_output &) -> uci_output & = delete;
+
+  // the least time between two progress updates, zero sends every one.
+  auto set_interval(std::chrono::milliseconds interval) -> void;
+
+  // queue text as it is, from any thread.
+  auto write(std::string_view text) -> void;
+
+  // from the search thread: an info line for each of the lines of a completed
+  // iteration, otherwise the move currently being searched if it has been long
+  // enough since the last update. a progress update is dropped rather than
+  // waiting if another thread is queueing something.
+  auto info(const search_info &info) -> void;
+
+  // from the search thread: the final info lines and best move of a search.
+  auto result(const search_result &result) -> void;
+
+  // block until everything queued so far has been written.
+  auto flush() -> void;
+
+private:
+  // progress waits for neither the lock nor room, an iteration waits for the
+  // lock only and a result for both.
+  enum class urgency { progress, iteration, result };
+
+  // queue line, false if it was dropped.
+  auto queue(urgency u) -> bool;
+  auto writer_loop() -> void;
+
+  std::ostream &os;
+  std::atomic<std::chrono::milliseconds::rep> interval;
+
+  // only used by the search thread, so it can format without holding the lock.
+  std::string line;
+  std::chrono::milliseconds last_progress{};
+
+  std::mutex lock;
+  std::condition_variable ready;
+  std::condition_variable written;
+  std::string pending;
+  std::string writing;
+  bool busy = false;
+  bool done = false;
+
+  std::thread writer;
+};
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_UCI_OUTPUT_HPP
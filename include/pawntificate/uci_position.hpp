@@ -0,0 +1,40 @@
+#ifndef PAWNTIFICATE_UCI_POSITION_HPP
+#define PAWNTIFICATE_UCI_POSITION_HPP
+
+#include <string>
+#include <string_view>
+
+#include "pawntificate/board.hpp"
+#include "pawntificate/key_history.hpp"
+
+namespace pawntificate {
+
+// the position of the game the gui is playing, as set by the position command.
+// guis resend every move of the game each time, so when the moves carry on from
+// the ones last sent only the new ones are played, along with their keys.
+class uci_position {
+public:
+  // the start position, given as a fen or the start position of a standard game
+  // if it is empty, followed by a list of UCI moves. false if the fen can't be
+  // parsed, in which case the position is left as it was.
+  auto set(std::string_view fen, std::string_view moves) -> bool;
+
+  auto position() const -> const board & {
+    return current;
+  }
+
+  // the keys of the positions before the current one, for spotting repetitions.
+  auto history() const -> const key_history & {
+    return keys;
+  }
+
+private:
+  std::string start;
+  std::string played;
+  board current;
+  key_history keys;
+};
+
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_UCI_POSITION_HPP
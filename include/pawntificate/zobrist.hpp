@@ -0,0 +1,60 @@
+#ifndef PAWNTIFICATE_ZOBRIST_HPP
+#define PAWNTIFICATE_ZOBRIST_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace pawntificate {
+namespace zobrist {
+
+// the random numbers are generated at compile time with splitmix64 so that the
+// hash of a position is the same on every run (and every thread).
+constexpr auto splitmix64(std::uint64_t &state) -> std::uint64_t {
+  std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27u)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31u);
+}
+
+struct key_table {
+  // indexed by piece opcode and then square. the null piece hashes to zero so
+  // that empty squares don't contribute to the hash.
+  std::array<std::array<std::uint64_t, 64>, 16> pieces{};
+
+  // indexed by the castle bit set.
+  std::array<std::uint64_t, 16> castling{};
+
+  // indexed by the file of the en passant square.
+  std::array<std::uint64_t, 8> en_passant{};
+
+  // xor'd in when it is black to move.
+  std::uint64_t black_to_move = 0;
+};
+
+constexpr key_table keys = [] {
+  key_table k;
+  std::uint64_t state = 0x70617776746966ull;
+
+  // opcodes 0 and 1 are the null piece and a white piece with no type.
+  for (unsigned p = 2; p < k.pieces.size(); ++p) {
+    for (auto &s : k.pieces[p]) {
+      s = splitmix64(state);
+    }
+  }
+
+  for (unsigned c = 1; c < k.castling.size(); ++c) {
+    k.castling[c] = splitmix64(state);
+  }
+
+  for (auto &f : k.en_passant) {
+    f = splitmix64(state);
+  }
+
+  k.black_to_move = splitmix64(state);
+  return k;
+}();
+
+} // namespace zobrist
+} // namespace pawntificate
+
+#endif // PAWNTIFICATE_ZOBRIST_HPP
@@ -0,0 +1,109 @@
+#include "pawntificate/batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <random>
+#include <thread>
+
+#include "cxx/run_threads.hpp"
+#include "pawntificate/engine.hpp"
+#include "pawntificate/psqt.hpp"
+
+namespace pawntificate {
+
+namespace {
+
+// positions are handed out to the threads this many at a time.
+constexpr std::size_t evaluate_chunk = 4096ul;
+constexpr std::size_t search_chunk = 16ul;
+
+auto thread_count(const std::size_t threads, const std::size_t positions, const std::size_t chunk)
+    -> std::size_t {
+  const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+  const auto chunks = (positions + chunk - 1) / chunk;
+  return std::clamp(threads == 0 ? cores : threads, 1ul, std::max(chunks, 1ul));
+}
+
+} // unnamed namespace
+
+auto evaluation_columns::resize(const std::size_t n) -> void {
+  mg.resize(n);
+  eg.resize(n);
+  phase.resize(n);
+  sign.resize(n);
+}
+
+auto gather(const std::span<const board> boards, pawn_table &pawns, evaluation_columns &columns) -> void {
+  columns.resize(boards.size());
+  for (auto i = 0ul; i < boards.size(); ++i) {
+    const auto &b = boards[i];
+    const auto &p = pawns.probe(b);
+    columns.mg[i] = b.psq.mg + p.mg;
+    columns.eg[i] = b.psq.eg + p.eg;
+    columns.phase[i] = b.psq.phase;
+    columns.sign[i] = b.active == colour::white ? 1 : -1;
+  }
+}
+
+auto evaluate_columns(const evaluation_columns &columns, const std::span<score> scores) -> void {
+  assert(scores.size() >= columns.size());
+
+  const auto n = columns.size();
+  const auto out = scores.first(n);
+  psqt::blend(columns.mg, columns.eg, columns.phase, out);
+  for (auto i = 0ul; i < n; ++i) {
+    out[i] *= columns.sign[i];
+  }
+}
+
+auto evaluate_positions(const std::span<const board> boards,
+                        const std::span<score> scores,
+                        const std::size_t threads) -> void {
+  assert(scores.size() >= boards.size());
+
+  std::atomic<std::size_t> next{0};
+  cxx::run_threads(thread_count(threads, boards.size(), evaluate_chunk), [&](std::size_t) {
+    pawn_table pawns;
+    evaluation_columns columns;
+
+    for (auto first = next.fetch_add(evaluate_chunk); first < boards.size();
+         first = next.fetch_add(evaluate_chunk)) {
+      const auto n = std::min(evaluate_chunk, boards.size() - first);
+      gather(boards.subspan(first, n), pawns, columns);
+      evaluate_columns(columns, scores.subspan(first, n));
+    }
+  });
+}
+
+auto search_positions(const std::span<const board> boards,
+                      const std::size_t depth,
+                      const std::span<score> scores,
+                      const std::size_t threads) -> void {
+  assert(scores.size() >= boards.size());
+  assert(depth > 0);
+
+  std::atomic<std::size_t> next{0};
+  cxx::run_threads(thread_count(threads, boards.size(), search_chunk), [&](std::size_t) {
+    engine e;
+    std::mt19937 gen;
+    move_list moves;
+
+    for (auto first = next.fetch_add(search_chunk); first < boards.size();
+         first = next.fetch_add(search_chunk)) {
+      const auto last = std::min(first + search_chunk, boards.size());
+      for (auto i = first; i < last; ++i) {
+        // the search needs a move to make, otherwise the game is already over:
+        // checkmate or a stalemate, which is a draw.
+        find_legal_moves(boards[i], moves);
+        if (moves.empty()) {
+          scores[i] = in_check(boards[i]) ? -mate : 0;
+        } else {
+          scores[i] = e.search(boards[i], depth, gen).value;
+        }
+      }
+    }
+  });
+}
+
+} // namespace pawntificate
@@ -0,0 +1,41 @@
+#include "pawntificate/bench.hpp"
+
+#include <cassert>
+#include <random>
+
+namespace pawntificate {
+
+auto bench(engine &e,
+           const std::size_t depth,
+           const std::function<void(std::size_t, const search_result &)> &on_position) -> bench_result {
+  assert(depth > 0);
+
+  search_limits limits;
+  limits.depth = depth;
+
+  bench_result total;
+  for (auto i = 0ul; i < bench_positions.size(); ++i) {
+    board b;
+    [[maybe_unused]] const bool parsed = parse_fen(bench_positions[i], b);
+    assert(parsed);
+
+    e.new_game();
+    std::mt19937 gen;
+
+    search_result result;
+    e.start(b, key_history{}, limits, gen, [&result](const search_result &r) {
+      result = r;
+    });
+    e.wait();
+
+    total.nodes += result.nodes;
+    total.time += result.time;
+    if (on_position) {
+      on_position(i, result);
+    }
+  }
+
+  return total;
+}
+
+} // namespace pawntificate
@@ -1,5 +1,7 @@
 #include "pawntificate/board.hpp"
 
+#include <charconv>
+
 namespace pawntificate {
 
 namespace {
@@ -9,6 +11,23 @@ constexpr std::array<P, 8> knight_offsets{
   P(1, 2), P(1, -2), P(2, 1), P(2, -1), P(-1, 2), P(-1, -2), P(-2, 1), P(-2, -1)
 };
 
+// a board with nothing on it, the starting point for setting up a position.
+constexpr board empty_board{colour::white, {}, castle::_};
+
+// the piece for each FEN letter, the null piece for anything else.
+constexpr auto fen_pieces = [] {
+  std::array<piece, 256> t{};
+  for (const auto p : {pieces::P, pieces::N, pieces::B, pieces::R, pieces::Q, pieces::K,
+                       pieces::p, pieces::n, pieces::b, pieces::r, pieces::q, pieces::k}) {
+    // the letters are upper case for white.
+    constexpr std::string_view letters{" pnbrqk"};
+    const auto letter = letters[static_cast<std::size_t>(p.type())];
+    t[static_cast<unsigned char>(p.colour() == colour::white ? letter - 'a' + 'A' : letter)] = p;
+  }
+
+  return t;
+}();
+
 auto get_piece(const board &b, const square s) -> piece {
   const auto id = static_cast<std::size_t>(s);
   assert(id < b.piece_board.size());
@@ -200,7 +219,9 @@ auto king_is_safe(const board &b, const square king, const square from, const sq
 // under threat after such a move is made.
 class move_generator {
 public:
-  explicit move_generator(const board &b) : b{b}, king{find_king(b)}, moves{} {}
+  move_generator(const board &b, move_list &moves) : b{b}, king{find_king(b)}, moves{moves} {
+    moves.clear();
+  }
 
   auto add_move(const square from, const square to) -> void {
     if (king_is_safe(b, king, from, to)) {
@@ -220,10 +241,6 @@ public:
     }
   }
 
-  auto release() {
-    return std::move(moves);
-  }
-
 private:
   // for now only captures are killer moves.
   // TODO: check should be too
@@ -234,7 +251,7 @@ private:
 
   const board &b;
   square king;
-  std::vector<move> moves;
+  move_list &moves;
 };
 
 auto find_legal_pawn_moves(const square s,
@@ -507,7 +524,13 @@ auto find_legal_king_moves(const square s,
 } // unnamed namespace
 
 auto find_legal_moves(const board &b) -> std::vector<move> {
-  move_generator moves{b};
+  move_list moves;
+  find_legal_moves(b, moves);
+  return {std::begin(moves), std::end(moves)};
+}
+
+auto find_legal_moves(const board &b, move_list &buffer) -> void {
+  move_generator moves{b, buffer};
 
   // walk through board, for each piece who's turn it is populate the moves
   // vector with their legal moves.
@@ -542,7 +565,190 @@ auto find_legal_moves(const board &b) -> std::vector<move> {
     }
   }
 
-  return moves.release();
+}
+
+auto in_check(const board &b) -> bool {
+  return !king_is_safe(b, find_king(b), square::_, square::_);
+}
+
+auto to_san(std::ostream &os, const board &b, const move m) -> std::ostream & {
+  const auto from = static_cast<std::uint8_t>(m.from());
+  const auto to = static_cast<std::uint8_t>(m.to());
+  const auto p = b.piece_board[from].type();
+
+  const auto file = [](const std::uint8_t s) {
+    return static_cast<char>('a' + s % 8);
+  };
+
+  const auto rank = [](const std::uint8_t s) {
+    return static_cast<char>('1' + s / 8);
+  };
+
+  if (p == ptype::king && (from % 8 + 2 == to % 8 || to % 8 + 2 == from % 8)) {
+    os << (to % 8 > from % 8 ? "O-O" : "O-O-O");
+  } else {
+    // a pawn that changes file is capturing, even if the square is empty when
+    // it takes en passant.
+    const bool capture = b.piece_board[to] != pieces::_ || (p == ptype::pawn && from % 8 != to % 8);
+
+    if (p == ptype::pawn) {
+      if (capture) {
+        os << file(from);
+      }
+    } else {
+      os << "PNBRQK"[static_cast<std::size_t>(p) - 1];
+
+      // the other pieces of the same type that can go to the same square.
+      move_list moves;
+      find_legal_moves(b, moves);
+      bool ambiguous = false;
+      bool same_file = false;
+      bool same_rank = false;
+      for (const auto other : moves) {
+        const auto s = static_cast<std::uint8_t>(other.from());
+        if (other.to() == m.to() && s != from && b.piece_board[s].type() == p) {
+          ambiguous = true;
+          same_file = same_file || s % 8 == from % 8;
+          same_rank = same_rank || s / 8 == from / 8;
+        }
+      }
+
+      // the file if that is enough, otherwise the rank, otherwise both.
+      if (ambiguous && (!same_file || same_rank)) {
+        os << file(from);
+      }
+
+      if (ambiguous && same_file) {
+        os << rank(from);
+      }
+    }
+
+    if (capture) {
+      os << 'x';
+    }
+
+    os << file(to) << rank(to);
+    if (m.promote_to() != ptype::_) {
+      os << '=' << "PNBRQK"[static_cast<std::size_t>(m.promote_to()) - 1];
+    }
+  }
+
+  const board next{b, m};
+  if (in_check(next)) {
+    move_list replies;
+    find_legal_moves(next, replies);
+    os << (replies.empty() ? '#' : '+');
+  }
+
+  return os;
+}
+
+auto parse_fen(const std::string_view fen, board &b) -> bool {
+  auto c = std::begin(fen);
+  const auto end = std::end(fen);
+
+  // the next field, skipping the spaces before it.
+  const auto next_field = [&]() -> std::string_view {
+    while (c != end && *c == ' ') {
+      ++c;
+    }
+
+    const auto first = c;
+    while (c != end && *c != ' ') {
+      ++c;
+    }
+
+    return {first, static_cast<std::size_t>(c - first)};
+  };
+
+  // the hash and the totals are kept up to date as each piece is placed rather
+  // than worked out from every square at the end.
+  board next = empty_board;
+
+  // the placement starts from a8 and works along each rank down to a1.
+  std::array<int, 2> kings{};
+  int rank = 7;
+  int file = 0;
+  for (const auto ch : next_field()) {
+    if (ch == '/') {
+      if (file != 8 || rank == 0) {
+        return false;
+      }
+
+      --rank;
+      file = 0;
+    } else if (ch >= '1' && ch <= '8') {
+      file += ch - '0';
+      if (file > 8) {
+        return false;
+      }
+    } else {
+      const auto p = fen_pieces[static_cast<unsigned char>(ch)];
+      if (p == pieces::_ || file > 7) {
+        return false;
+      }
+
+      if (p.type() == ptype::king) {
+        ++kings[static_cast<std::size_t>(p.colour())];
+      }
+
+      const auto s = make_square(file++, rank);
+      const auto i = static_cast<std::size_t>(s);
+      next.piece_board[i] = p;
+      next.hash ^= piece_key(s, p);
+      next.pawn_hash ^= pawn_key(s, p);
+      next.psq.add(p.opcode, i);
+    }
+  }
+
+  if (rank != 0 || file != 8 || kings[0] != 1 || kings[1] != 1) {
+    return false;
+  }
+
+  if (const auto field = next_field(); field == "b") {
+    next.active = colour::black;
+    next.hash ^= active_key(colour::black);
+  } else if (field != "w") {
+    return false;
+  }
+
+  if (const auto field = next_field(); field != "-") {
+    if (field.empty()) {
+      return false;
+    }
+
+    for (const auto ch : field) {
+      switch (ch) {
+        case 'K': next.castling = next.castling | castle::white_short; break;
+        case 'Q': next.castling = next.castling | castle::white_long; break;
+        case 'k': next.castling = next.castling | castle::black_short; break;
+        case 'q': next.castling = next.castling | castle::black_long; break;
+        default: return false;
+      }
+    }
+
+    next.hash ^= castling_key(castle::_) ^ castling_key(next.castling);
+  }
+
+  if (const auto field = next_field(); field != "-") {
+    if (field.size() != 2 || field[0] < 'a' || field[0] > 'h' || (field[1] != '3' && field[1] != '6')) {
+      return false;
+    }
+
+    next.en_passant = to_square(field[0], field[1]);
+    next.hash ^= en_passant_key(next.en_passant);
+  }
+
+  // the clocks are optional, an EPD line has its operations here instead. a
+  // fullmove number of zero is sometimes seen and taken to mean the first.
+  const auto halfmove = next_field();
+  std::from_chars(halfmove.data(), halfmove.data() + halfmove.size(), next.halfmove);
+  const auto fullmove = next_field();
+  std::from_chars(fullmove.data(), fullmove.data() + fullmove.size(), next.fullmove);
+  next.fullmove = std::max<std::uint16_t>(next.fullmove, 1u);
+
+  b = next;
+  return true;
 }
 
 } // namespace pawntificate
@@ -0,0 +1,1237 @@
+#include "pawntificate/engine.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "pawntificate/pawns.hpp"
+
+namespace pawntificate {
+
+namespace {
+
+constexpr score infinity = std::numeric_limits<score>::max();
+constexpr score draw = 0;
+
+// how many nodes a thread searches between each check of the stop flag.
+constexpr std::uint64_t stop_check_interval = 1024ul;
+
+// nodes with less depth remaining than this are not worth sharing out.
+constexpr std::size_t min_split_depth = 2ul;
+
+// how many of the children of a frontier node are evaluated together, after
+// the first which is evaluated on its own as it is the most likely to cutoff.
+constexpr std::size_t frontier_chunk = 8ul;
+
+// the number of frames on each thread's search stack. a thread that helps with
+// other split points while it waits for its own carries on from the top of its
+// stack, so there is room for a few searches nested inside each other.
+constexpr std::size_t stack_size = 4ul * (max_depth + 2ul);
+
+using line = cxx::static_vector<move, max_depth>;
+
+// what a node needs to search its moves, preallocated on each thread's search
+// stack so that searching never allocates. boards are copy-made on the call
+// stack so they don't need a place here.
+struct frame {
+  move_list moves;
+
+  // quiet moves that caused a cutoff at this ply, tried straight after the
+  // captures (which is what move::killer means).
+  std::array<move, 2> killers;
+
+  // the evaluation of the position, only known at the leaves.
+  score static_eval = 0;
+
+  // the network's accumulator for the position, only kept up to date when
+  // evaluating with a network.
+  nnue::accumulator acc;
+
+  // the best line from this node, built from the frame above.
+  line pv;
+};
+
+// a move at the root along with what was learnt about it in the last iteration.
+struct root_move {
+  move m;
+  score value = -infinity;
+  std::uint64_t nodes = 0;
+  line pv{};
+};
+
+struct split_point;
+
+} // unnamed namespace
+
+// everything a single search thread works with. with lazy smp the transposition
+// table and the evaluation cache are the only state shared between the
+// threads. these live as long as the engine's threads so nothing is allocated
+// per search.
+struct search_worker {
+  search_worker(transposition_table &tt, eval_cache &evals, std::atomic<bool> &stop)
+  : tt{tt}, evals{evals}, stop{stop}, stack{std::make_unique<frame[]>(stack_size)} {
+    result.lines.reserve(1);
+  }
+
+  transposition_table &tt;
+  eval_cache &evals;
+  std::atomic<bool> &stop;
+
+  // the main thread orders its moves with the generator it is given, the
+  // helpers each use their own seeded from it.
+  std::mt19937 own_gen;
+  std::mt19937 *gen = &own_gen;
+  std::uint64_t nodes = 0;
+  std::uint64_t eval_hits = 0;
+  std::uint64_t eval_misses = 0;
+
+  // the helpers add their nodes to this as they go, so the main thread can
+  // report a total while the search is running.
+  std::atomic<std::uint64_t> *searched = nullptr;
+
+  // the ply of the deepest leaf this thread has reached.
+  std::size_t seldepth = 0;
+
+  // only the main thread reports how the search is going, timed from start.
+  const std::function<void(const search_info &)> *on_info = nullptr;
+  std::chrono::steady_clock::time_point start;
+
+  // set once this thread has seen the stop flag.
+  bool stopped = false;
+
+  // only the main thread keeps an eye on the time, it stops the others. an
+  // iteration isn't started once this fraction of the time has been used.
+  const search_clock *clock = nullptr;
+  double next_iteration = 0.5;
+
+  // this thread's share of the node budget, every thread stops once one has
+  // used its share.
+  std::uint64_t node_limit = std::numeric_limits<std::uint64_t>::max();
+
+  // the network the leaves are evaluated with, or null for the piece-square
+  // tables.
+  const nnue::network *net = nullptr;
+
+  // the pawn structures this thread has evaluated, kept between searches.
+  pawn_table pawns;
+
+  // the positions of the game so far followed by the current search path.
+  key_history history{};
+
+  // top is the next free frame, each node claims one for as long as it is
+  // being searched.
+  std::unique_ptr<frame[]> stack;
+  frame *top = nullptr;
+
+  // the moves at the root and what this thread's iterative deepening found.
+  cxx::static_vector<root_move, max_moves> root_moves;
+  search_result result;
+
+  // tree splitting: the pool that the remaining moves of a node are shared out
+  // on, all of the workers (indexed by pool thread) and the innermost split
+  // point this thread is currently searching under.
+  cxx::work_stealing_pool *pool = nullptr;
+  search_worker *team = nullptr;
+  std::size_t id = 0;
+  const split_point *split = nullptr;
+
+  auto aborted() const -> bool;
+
+  // whether there are enough free frames left to search another split point.
+  auto has_room() const -> bool {
+    return top + max_depth + 2 <= stack.get() + stack_size;
+  }
+};
+
+namespace {
+
+// claims the next frame of the search stack for as long as a node is searched.
+struct frame_guard {
+  explicit frame_guard(search_worker &w) : w{w}, f{*w.top++} {
+    assert(w.top <= w.stack.get() + stack_size);
+    f.pv.clear();
+  }
+
+  ~frame_guard() {
+    --w.top;
+  }
+
+  frame_guard(const frame_guard &) = delete;
+  auto operator=(const frame_guard &) -> frame_guard & = delete;
+
+  search_worker &w;
+  frame &f;
+};
+
+// find legal moves and sort them so the best moves are first (probably). the
+// best move from a previous search of the position goes first, the rest of the
+// order is derived from the killer bit being set or not and then the quiet
+// moves that caused cutoffs in sibling positions.
+auto find_and_sort_legal_moves(const board &b,
+                               const move hash_move,
+                               const std::array<move, 2> &killers,
+                               std::mt19937 &gen,
+                               move_list &moves) -> void {
+  find_legal_moves(b, moves);
+
+  auto begin = std::begin(moves);
+  auto end = std::end(moves);
+
+  if (const auto it = std::find(begin, end, hash_move); it != end) {
+    std::rotate(begin, it, it + 1);
+    ++begin;
+  }
+
+  // first put all killer moves to the start.
+  auto killer_end = std::partition(begin, end, [](const move &m) {
+    return m.killer();
+  });
+
+  // sort the killer moves by promotion.
+  std::sort(begin, killer_end, [](const move &lhs, const move &rhs) {
+    // strongest first.
+    return !(lhs.promote_to() < rhs.promote_to());
+  });
+
+  auto quiet_end = std::partition(killer_end, end, [&killers](const move &m) {
+    return m == killers[0] || m == killers[1];
+  });
+
+  // finally randomly shuffle the remaining moves.
+  std::shuffle(quiet_end, end, gen);
+}
+
+// the best line through a node is its best move followed by the best line of
+// the position after it.
+auto set_pv(line &pv, const move m, const line &rest) -> void {
+  pv.clear();
+  pv.push_back(m);
+  for (auto i = 0ul; i < rest.size() && !pv.full(); ++i) {
+    pv.push_back(rest[i]);
+  }
+}
+
+// remember a quiet move that caused a cutoff so it is tried early in the
+// positions next to this one.
+auto add_killer(frame &f, const move m) -> void {
+  if (!m.killer() && m.promote_to() == ptype::_ && f.killers[0] != m) {
+    f.killers[1] = f.killers[0];
+    f.killers[0] = m;
+  }
+}
+
+// what is known about a node before it is searched, which decides at compile
+// time how it is searched.
+enum class node_type {
+  // the root, whose moves are searched from the list of root moves so that
+  // they can be ranked for multi pv and the next iteration.
+  root,
+
+  // a node on the principal variation, searched with an open window. only
+  // these record the principal variation.
+  pv,
+
+  // every other node, searched with a null window to prove that it is no better
+  // than a move that has already been found. only these are pruned.
+  non_pv
+};
+
+/*
+
+function negamax(node, depth, α, β) is
+    if depth = 0 or node is a terminal node then
+        return the heuristic value of node
+    value := −∞
+    for each child of node do
+        value := max(value, −negamax(child, depth − 1, −β, −α))
+        α := max(α, value)
+        if α ≥ β then
+            break (* cut-off *)
+    return value
+
+scores are always relative to the side to move. the first move of a pv node is
+searched with the full window, the rest with a null window around α that only
+needs searching again if it unexpectedly beats α (principal variation search).
+
+*/
+
+// a node whose remaining moves are being searched by several threads at once.
+struct split_point {
+  const board &b;
+
+  // the frame of the node that was split, its moves are shared out and its
+  // principal variation and killers are updated under the lock.
+  frame &f;
+  const std::size_t depth;
+  const std::size_t ply;
+  search_worker *team;
+  const split_point *parent;
+
+  // the path to this node, for the threads that didn't search their way here.
+  const key_history history;
+
+  // guards everything below except the atomics.
+  std::mutex lock;
+  std::size_t next;
+  score alpha;
+  score beta;
+  score value;
+  move best;
+
+  std::atomic<bool> cutoff{false};
+  std::atomic<std::size_t> pending{0};
+};
+
+} // unnamed namespace
+
+auto search_worker::aborted() const -> bool {
+  if (stopped) {
+    return true;
+  }
+
+  // a cutoff at any node above this one means its result is no longer needed.
+  for (auto sp = split; sp != nullptr; sp = sp->parent) {
+    if (sp->cutoff.load(std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+namespace {
+
+// reduced is set for the nodes below a late move reduction, there is only ever
+// one reduction on a path.
+template <node_type node, bool reduced>
+auto negamax(search_worker &w,
+             const board &b,
+             move m,
+             std::size_t depth,
+             std::size_t ply,
+             score alpha,
+             score beta) -> score;
+
+// search a child of a node. the first move of a pv node is on the principal
+// variation, any other move is assumed to be worse than the best so far which
+// a null window proves cheaply. if it isn't it is searched again properly.
+// parent is the frame of the node the move is made from, the child's
+// accumulator is updated from it in the frame the child will claim.
+template <node_type node, bool reduced>
+auto search_move(search_worker &w,
+                 const board &b,
+                 const frame &parent,
+                 const move m,
+                 const std::size_t depth,
+                 const std::size_t ply,
+                 const score alpha,
+                 const score beta,
+                 const bool first) -> score {
+  const board next{b, m};
+  if (w.net != nullptr) {
+    w.net->update(b, parent.acc, next, w.top->acc);
+  }
+
+  if constexpr (node == node_type::non_pv) {
+    return -negamax<node_type::non_pv, reduced>(w, next, m, depth, ply + 1, -beta, -alpha);
+  } else {
+    if (first) {
+      return -negamax<node_type::pv, false>(w, next, m, depth, ply + 1, -beta, -alpha);
+    }
+
+    const auto v = -negamax<node_type::non_pv, false>(w, next, m, depth, ply + 1, -alpha - 1, -alpha);
+    if (v <= alpha || v >= beta || w.aborted()) {
+      return v;
+    }
+
+    return -negamax<node_type::pv, false>(w, next, m, depth, ply + 1, -beta, -alpha);
+  }
+}
+
+// take moves from the split point one at a time until there are none left or
+// one of them causes a cutoff.
+template <node_type node, bool reduced>
+auto search_split_moves(search_worker &w, split_point &sp) -> void {
+  const auto outer = w.split;
+  const auto outer_history = w.history;
+  w.split = &sp;
+  w.history = sp.history;
+
+  std::unique_lock lock{sp.lock};
+  while (sp.next < sp.f.moves.size() && !w.aborted()) {
+    const auto m = sp.f.moves[sp.next++];
+    const auto alpha = sp.alpha;
+    const auto beta = sp.beta;
+    lock.unlock();
+
+    const auto v = search_move<node, reduced>(w, sp.b, sp.f, m, sp.depth, sp.ply, alpha, beta, false);
+
+    lock.lock();
+    if (w.aborted()) {
+      break;
+    }
+
+    if (v > sp.value) {
+      sp.value = v;
+      sp.best = m;
+      if constexpr (node != node_type::non_pv) {
+        set_pv(sp.f.pv, m, w.top->pv);
+      }
+    }
+
+    sp.alpha = std::max(sp.alpha, sp.value);
+    if (sp.alpha >= sp.beta) {
+      sp.cutoff.store(true, std::memory_order_relaxed);
+      add_killer(sp.f, m);
+    }
+  }
+
+  w.split = outer;
+  w.history = outer_history;
+}
+
+auto can_split(const search_worker &w, const std::size_t depth, const std::size_t move_count) -> bool {
+  return w.pool != nullptr && depth >= min_split_depth && move_count > 2;
+}
+
+// young brothers wait: once the first move of a node has been searched the
+// rest are shared out between any idle threads. the thread that owns the node
+// searches them too and then helps with whatever work is left in the pool
+// until every thread has finished with its moves.
+template <node_type node, bool reduced>
+auto split(search_worker &w,
+           const board &b,
+           frame &f,
+           const std::size_t depth,
+           const std::size_t ply,
+           const score alpha,
+           const score beta,
+           score &value,
+           move &best) -> void {
+  split_point sp{b, f, depth, ply, w.team, w.split, w.history,
+                 {}, 1, alpha, beta, value, best};
+
+  const auto run = [](void *context, const std::size_t thread) {
+    auto &sp = *static_cast<split_point *>(context);
+    search_split_moves<node, reduced>(sp.team[thread], sp);
+    sp.pending.fetch_sub(1, std::memory_order_acq_rel);
+  };
+
+  const auto helpers = std::min(w.pool->size() - 1, f.moves.size() - 2);
+  for (auto i = 0ul; i < helpers; ++i) {
+    sp.pending.fetch_add(1, std::memory_order_relaxed);
+    if (!w.pool->push(w.id, {run, &sp})) {
+      sp.pending.fetch_sub(1, std::memory_order_relaxed);
+      break;
+    }
+  }
+
+  search_split_moves<node, reduced>(w, sp);
+  while (sp.pending.load(std::memory_order_acquire) > 0) {
+    if (!w.has_room() || !w.pool->run_one(w.id)) {
+      std::this_thread::yield();
+    }
+  }
+
+  value = sp.value;
+  best = sp.best;
+}
+
+// fill in the totals so far and pass the info on to the handler.
+auto report(const search_worker &w, search_info &info) -> void {
+  info.seldepth = w.seldepth;
+  info.nodes = w.nodes + w.searched->load(std::memory_order_relaxed);
+  info.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - w.start);
+  (*w.on_info)(info);
+}
+
+// the search stops to check the clock and the stop flag every so often. the
+// node budget is a comparison so it is checked every time, to stop on the
+// node.
+auto poll_stop(search_worker &w) -> void {
+  if (w.nodes >= w.node_limit) {
+    w.stop.store(true, std::memory_order_relaxed);
+    w.stopped = true;
+  } else if (w.nodes % stop_check_interval == 0) {
+    if (w.id != 0) {
+      w.searched->fetch_add(stop_check_interval, std::memory_order_relaxed);
+    }
+
+    if (w.clock != nullptr && w.clock->expired()) {
+      w.stop.store(true, std::memory_order_relaxed);
+    }
+
+    w.stopped = w.stop.load(std::memory_order_relaxed);
+  }
+}
+
+// the static evaluation of a leaf, from the cache if it has been seen before.
+auto static_eval(search_worker &w, const board &b, const frame &f) -> score {
+  score value;
+  if (w.evals.probe(b.hash, value)) {
+    ++w.eval_hits;
+    return value;
+  }
+
+  ++w.eval_misses;
+  value = w.net != nullptr ? w.net->evaluate(b, f.acc) : evaluate_position(b, w.pawns);
+  w.evals.store(b.hash, value);
+  return value;
+}
+
+// the children of a frontier node, a node one ply above the leaves, are
+// evaluated in chunks rather than searched: their piece-square and pawn totals
+// are gathered and then blended together in one pass. each chunk's moves are
+// then gone through in order as if they had been searched one at a time, so
+// the result is the same, and a cutoff leaves the rest of the moves
+// unevaluated. only the piece-square evaluator is batched, the network is
+// evaluated a leaf at a time.
+template <node_type node>
+auto search_frontier(search_worker &w,
+                     const board &b,
+                     frame &f,
+                     score alpha,
+                     const score beta,
+                     move &best) -> score {
+  // from white's point of view, which is the parent's when it is white to move.
+  const auto sign = b.active == colour::white ? 1 : -1;
+
+  auto value = -infinity;
+  for (auto first = 0ul, n = 0ul; first < f.moves.size(); first += n) {
+    n = std::min(f.moves.size() - first, first == 0 ? 1ul : frontier_chunk);
+
+    psqt::batch<frontier_chunk> totals;
+    std::array<score, frontier_chunk> values;
+    std::array<std::uint64_t, frontier_chunk> keys;
+    std::array<bool, frontier_chunk> known;
+
+    for (auto i = 0ul; i < n; ++i) {
+      const board next{b, f.moves[first + i]};
+      keys[i] = next.hash;
+
+      // the same draws that the leaf itself would have found.
+      known[i] = true;
+      totals.mg[i] = totals.eg[i] = totals.phase[i] = 0;
+      if (next.halfmove >= 100 || w.history.is_repetition(next.hash, next.halfmove)) {
+        values[i] = draw;
+      } else if (score v; w.evals.probe(next.hash, v)) {
+        ++w.eval_hits;
+        values[i] = -v;
+      } else {
+        ++w.eval_misses;
+        known[i] = false;
+
+        const auto &pawns = w.pawns.probe(next);
+        totals.mg[i] = next.psq.mg + pawns.mg;
+        totals.eg[i] = next.psq.eg + pawns.eg;
+        totals.phase[i] = next.psq.phase;
+      }
+    }
+
+    std::array<std::int32_t, frontier_chunk> blended;
+    psqt::blend(totals, n, blended);
+
+    for (auto i = 0ul; i < n; ++i) {
+      if (!known[i]) {
+        values[i] = sign * blended[i];
+        w.evals.store(keys[i], -values[i]);
+      }
+    }
+
+    for (auto i = 0ul; i < n; ++i) {
+      const auto m = f.moves[first + i];
+      ++w.nodes;
+      poll_stop(w);
+      if (w.stopped) {
+        return value;
+      }
+
+      if (values[i] > value || best == move{}) {
+        value = values[i];
+        best = m;
+        if constexpr (node != node_type::non_pv) {
+          set_pv(f.pv, m, line{});
+        }
+      }
+
+      alpha = std::max(alpha, value);
+      if (alpha >= beta) {
+        add_killer(f, m);
+        return value;
+      }
+    }
+  }
+
+  return value;
+}
+
+// search the moves of a node that has already had its moves generated into its
+// frame, returning the best score and move. reduced is passed on to children.
+template <node_type node, bool reduced>
+auto search_moves(search_worker &w,
+                  const board &b,
+                  frame &f,
+                  const std::size_t depth,
+                  const std::size_t ply,
+                  score alpha,
+                  const score beta,
+                  move &best) -> score {
+  if (depth == 0 && w.net == nullptr) {
+    w.seldepth = std::max(w.seldepth, ply + 1);
+    return search_frontier<node>(w, b, f, alpha, beta, best);
+  }
+
+  auto value = -infinity;
+  for (auto i = 0ul; i < f.moves.size(); ++i) {
+    const auto m = f.moves[i];
+    const auto v = search_move<node, reduced>(w, b, f, m, depth, ply, alpha, beta, i == 0);
+
+    // the result is going to be thrown away, the rest of the moves would only
+    // add to the node count.
+    if (w.stopped) {
+      break;
+    }
+
+    if (v > value || best == move{}) {
+      value = v;
+      best = m;
+      if constexpr (node != node_type::non_pv) {
+        set_pv(f.pv, m, w.top->pv);
+      }
+    }
+
+    alpha = std::max(alpha, value);
+    if (alpha >= beta) {
+      add_killer(f, m);
+      break;
+    }
+
+    if (i == 0 && can_split(w, depth, f.moves.size())) {
+      split<node, reduced>(w, b, f, depth, ply, alpha, beta, value, best);
+      break;
+    }
+  }
+
+  return value;
+}
+
+// a mate is stored in the transposition table as the distance from the stored
+// position rather than from the root, as it could be reached by a different
+// number of plies next time.
+auto to_tt(const score s, const std::size_t ply) -> score {
+  const auto p = static_cast<score>(ply);
+  return s >= mate_bound ? s + p : s <= -mate_bound ? s - p : s;
+}
+
+auto from_tt(const score s, const std::size_t ply) -> score {
+  const auto p = static_cast<score>(ply);
+  return s >= mate_bound ? s - p : s <= -mate_bound ? s + p : s;
+}
+
+// entry point: search every root move, keeping the window's alpha at the score
+// of the multi_pv'th best move so far so that moves that can't make it into the
+// reported lines are refuted as cheaply as possible. afterwards the moves are
+// sorted best first, ready for the next iteration.
+auto search_root(search_worker &w,
+                 const board &b,
+                 const std::size_t depth,
+                 const std::size_t multi_pv) -> void {
+  frame_guard guard{w};
+  ++w.nodes;
+
+  if (w.net != nullptr) {
+    w.net->refresh(b, guard.f.acc);
+  }
+
+  auto &moves = w.root_moves;
+  assert(!moves.empty());
+
+  // the best scores of this iteration so far, strongest first.
+  cxx::static_vector<score, max_moves + 1> best;
+
+  for (auto &rm : moves) {
+    if (w.on_info != nullptr) {
+      search_info info;
+      info.depth = depth;
+      info.currmove = rm.m;
+      info.currmovenumber = static_cast<std::size_t>(&rm - std::begin(moves)) + 1;
+      report(w, info);
+    }
+
+    const auto alpha = best.size() < multi_pv ? -infinity : best.back();
+
+    const auto nodes = w.nodes;
+    const auto v = search_move<node_type::root, false>(w, b, guard.f, rm.m, depth - 1, 0, alpha,
+                                                       infinity, best.size() < multi_pv);
+    if (w.aborted()) {
+      return;
+    }
+
+    // a move that failed low only has an upper bound, so all that's known is
+    // that it isn't one of the best moves. these are ordered by how much effort
+    // it took to refute them instead.
+    rm.nodes = w.nodes - nodes;
+    rm.value = v > alpha ? v : -infinity;
+    set_pv(rm.pv, rm.m, w.top->pv);
+
+    if (v > alpha) {
+      best.insert(std::upper_bound(std::begin(best), std::end(best), v, std::greater<>{}), v);
+      if (best.size() > multi_pv) {
+        best.pop_back();
+      }
+    }
+  }
+
+  // an insertion sort rather than std::stable_sort, which allocates.
+  const auto better = [](const root_move &lhs, const root_move &rhs) {
+    return lhs.value > rhs.value || (lhs.value == rhs.value && lhs.nodes > rhs.nodes);
+  };
+
+  for (auto it = std::begin(moves); it != std::end(moves); ++it) {
+    std::rotate(std::upper_bound(std::begin(moves), it, *it, better), it, it + 1);
+  }
+}
+
+// find the score of a node by searching to a fixed depth.
+template <node_type node, bool reduced>
+auto negamax(search_worker &w,
+             const board &b,
+             const move m,
+             std::size_t depth,
+             const std::size_t ply,
+             score alpha,
+             score beta) -> score {
+  static_assert(node != node_type::root, "the root is searched by search_root");
+  static_assert(node == node_type::non_pv || !reduced, "pv nodes are never reduced");
+
+  frame_guard guard{w};
+  auto &f = guard.f;
+
+  ++w.nodes;
+  poll_stop(w);
+
+  // the fifty move rule, or a position that has been seen before and so could
+  // be repeated again. either is a draw, and cutting repetitions off here stops
+  // the search from going round in circles.
+  if (b.halfmove >= 100 || w.history.is_repetition(b.hash, b.halfmove)) {
+    return draw;
+  }
+
+  if (depth == 0) {
+    w.seldepth = std::max(w.seldepth, ply);
+    f.static_eval = static_eval(w, b, f);
+    return f.static_eval;
+  }
+
+  // the search has been stopped, or a sibling of a node above this one has
+  // caused a cutoff, so this result will be thrown away.
+  if (w.aborted()) {
+    return 0;
+  }
+
+  // mate distance pruning: nothing found below here can beat mating on the next
+  // move or be worse than being mated right now, so if the window is outside of
+  // those bounds a shorter mate has already been found elsewhere.
+  const auto p = static_cast<score>(ply);
+  alpha = std::max(alpha, -(mate - p));
+  beta = std::min(beta, mate - p - 1);
+  if (alpha >= beta) {
+    return alpha;
+  }
+
+  const auto draft = depth;
+  const auto original_alpha = alpha;
+
+  // pv nodes are searched properly, to keep the principal variation intact.
+  transposition entry;
+  if (w.tt.probe(b.hash, entry) && entry.depth >= draft && node == node_type::non_pv) {
+    const auto s = from_tt(entry.value, ply);
+    if (entry.type == bound::exact ||
+        (entry.type == bound::lower && s >= beta) ||
+        (entry.type == bound::upper && s <= alpha)) {
+      return s;
+    }
+  }
+
+  // no legal moves is either checkmate, scored by how many plies it took so
+  // that the quickest mate is preferred, or stalemate which is a draw.
+  find_and_sort_legal_moves(b, entry.best, f.killers, *w.gen, f.moves);
+  if (f.moves.empty()) {
+    return in_check(b) ? -(mate - p) : draw;
+  }
+
+  w.history.push(b.hash);
+
+  // late move reduction for non-killer moves below a certain depth, once per
+  // path and never on the principal variation.
+  move best;
+  score value;
+  if constexpr (node == node_type::non_pv && !reduced) {
+    if (!m.killer() && m.promote_to() == ptype::_ && depth >= 2 && depth <= 4) {
+      value = search_moves<node, true>(w, b, f, depth - 2, ply, alpha, beta, best);
+    } else {
+      value = search_moves<node, false>(w, b, f, depth - 1, ply, alpha, beta, best);
+    }
+  } else {
+    value = search_moves<node, reduced>(w, b, f, depth - 1, ply, alpha, beta, best);
+  }
+
+  w.history.pop();
+  if (!w.aborted()) {
+    const auto type = value <= original_alpha ? bound::upper
+                    : value >= beta ? bound::lower
+                    : bound::exact;
+
+    w.tt.store(b.hash, {best, to_tt(value, ply), static_cast<std::uint8_t>(draft), type});
+  }
+
+  return value;
+}
+
+// search one ply deeper each iteration, the order of the root moves and the
+// transposition table entries from the previous iteration decide which moves
+// are searched first in the next. the result is left in the worker.
+auto iterative_deepening(search_worker &w,
+                         const board &b,
+                         const std::size_t first_depth,
+                         const std::size_t max_depth,
+                         const std::size_t multi_pv,
+                         const move_list &searchmoves) -> void {
+  auto &result = w.result;
+  result.best = move{};
+  result.value = 0;
+  result.lines.clear();
+  result.depth = 0;
+
+  auto &moves = w.root_moves;
+  moves.clear();
+  // the moves given are matched against the legal ones by their squares and
+  // promotion, the only parts the gui knows about.
+  const auto allowed = [&searchmoves](const move m) {
+    return searchmoves.empty() || std::any_of(std::begin(searchmoves), std::end(searchmoves), [m](const move s) {
+      return s.from() == m.from() && s.to() == m.to() && s.promote_to() == m.promote_to();
+    });
+  };
+
+  find_and_sort_legal_moves(b, move{}, {}, *w.gen, w.top->moves);
+  for (const auto m : w.top->moves) {
+    if (allowed(m)) {
+      moves.push_back({m});
+    }
+  }
+
+  // none of them were legal, search everything instead.
+  if (moves.empty()) {
+    for (const auto m : w.top->moves) {
+      moves.push_back({m});
+    }
+  }
+
+  // in case the search is stopped before the first iteration completes.
+  assert(!moves.empty());
+  result.best = moves[0].m;
+
+  for (auto depth = first_depth; depth <= max_depth; ++depth) {
+    search_root(w, b, depth, multi_pv);
+    if (w.aborted()) {
+      break;
+    }
+
+    result.best = moves[0].m;
+    result.value = moves[0].value;
+    result.depth = depth;
+
+    result.lines.clear();
+    for (auto i = 0ul; i < std::min(multi_pv, moves.size()); ++i) {
+      result.lines.push_back({moves[i].value, moves[i].pv});
+    }
+
+    if (w.on_info != nullptr) {
+      search_info info;
+      info.depth = depth;
+      info.lines = result.lines;
+      info.hashfull = w.tt.hashfull();
+      report(w, info);
+    }
+
+    // a mate that happens within the depth searched can't be bettered by
+    // searching deeper, only longer lines would be found.
+    if (is_mate(result.value) && static_cast<std::size_t>(mate - std::abs(result.value)) <= depth) {
+      break;
+    }
+
+    // the next iteration takes longer than all of the previous ones combined,
+    // don't start one that is unlikely to finish.
+    if (w.clock != nullptr && w.clock->expired(w.next_iteration)) {
+      break;
+    }
+  }
+}
+
+// share the time left out over the moves left to play, keeping back a little
+// so that we never lose on time. a fixed move time takes priority.
+auto allocate_time(const search_limits &limits, const colour active) -> std::chrono::milliseconds {
+  using namespace std::chrono_literals;
+
+  if (limits.infinite) {
+    return 0ms;
+  } else if (limits.movetime.count() > 0) {
+    return limits.movetime;
+  } else if (!limits.timed()) {
+    return 0ms;
+  }
+
+  const auto time = active == colour::white ? limits.wtime : limits.btime;
+  const auto inc = active == colour::white ? limits.winc : limits.binc;
+  const auto moves = static_cast<std::chrono::milliseconds::rep>(limits.movestogo == 0 ? 30 : limits.movestogo);
+
+  const auto reserve = std::min(50ms, time / 10);
+  const auto budget = time / moves + inc * 3 / 4;
+  return std::max(1ms, std::min(budget, time - reserve));
+}
+
+} // unnamed namespace
+
+auto search_clock::reset(const std::chrono::milliseconds b, const bool ponder) -> void {
+  pondering.store(ponder);
+  start.store(clock::now().time_since_epoch().count());
+  budget.store(std::chrono::duration_cast<clock::duration>(b).count());
+}
+
+auto search_clock::ponderhit() -> void {
+  start.store(clock::now().time_since_epoch().count());
+  pondering.store(false);
+}
+
+auto search_clock::expired(const double fraction) const -> bool {
+  const auto b = budget.load(std::memory_order_relaxed);
+  if (b == 0 || pondering.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  const auto elapsed = clock::now().time_since_epoch().count() - start.load(std::memory_order_relaxed);
+  return elapsed > static_cast<clock::rep>(static_cast<double>(b) * fraction);
+}
+
+engine::engine()
+: own_tt{std::make_unique<transposition_table>(default_hash_size)}, tt{*own_tt} {
+  set_threads(1);
+  search_thread = std::thread([this] { idle_loop(); });
+}
+
+engine::engine(transposition_table &shared) : tt{shared} {
+  set_threads(1);
+  search_thread = std::thread([this] { idle_loop(); });
+}
+
+engine::~engine() {
+  stop();
+  wait();
+
+  {
+    std::lock_guard lock{job_lock};
+    quit = true;
+  }
+
+  job_ready.notify_one();
+  search_thread.join();
+}
+
+auto engine::set_threads(const std::size_t n) -> void {
+  wait();
+  threads = std::clamp(n, 1ul, max_threads);
+
+  // the search thread is the pool's first thread, the rest are helpers.
+  pool.reset();
+  workers.clear();
+  workers.reserve(threads);
+  for (auto i = 0ul; i < threads; ++i) {
+    workers.emplace_back(tt, evals, stop_flag);
+  }
+
+  workers[0].result.lines.reserve(multi_pv);
+  pool = std::make_unique<cxx::work_stealing_pool>(threads);
+}
+
+auto engine::set_parallel_search(const parallel_search p) -> void {
+  wait();
+  parallelism = p;
+}
+
+auto engine::set_multi_pv(const std::size_t n) -> void {
+  wait();
+  multi_pv = std::max(n, 1ul);
+  workers[0].result.lines.reserve(multi_pv);
+}
+
+auto engine::set_hash_size(const std::size_t megabytes) -> void {
+  wait();
+  tt.resize(megabytes);
+}
+
+auto engine::set_evaluator(const evaluator e) -> void {
+  wait();
+  eval = e;
+  evals.clear();
+}
+
+auto engine::load_network(const std::filesystem::path &path) -> bool {
+  wait();
+  evals.clear();
+  return network.load(path);
+}
+
+auto engine::load_parameters(const std::filesystem::path &path) -> bool {
+  wait();
+  auto params = psqt::defaults;
+  if (!psqt::load_parameters(path, params)) {
+    return false;
+  }
+
+  weights = psqt::make_weights(params);
+  evals.clear();
+  return true;
+}
+
+auto engine::set_info_handler(std::function<void(const search_info &)> f) -> void {
+  wait();
+  on_info = std::move(f);
+}
+
+auto engine::new_game() -> void {
+  wait();
+  tt.clear();
+  evals.clear();
+}
+
+auto engine::start(const board &b,
+                   const key_history &game,
+                   const search_limits &limits,
+                   std::mt19937 &gen,
+                   std::function<void(const search_result &)> on_finish) -> void {
+  wait();
+
+  // reset here rather than on the search thread so a stop that arrives before
+  // the thread is running isn't lost.
+  stop_flag.store(false);
+  clock.reset(allocate_time(limits, b.active), limits.ponder);
+  {
+    std::lock_guard lock{ponder_lock};
+    pondering = limits.ponder;
+    infinite = limits.infinite;
+    stop_requested = false;
+  }
+
+  {
+    std::lock_guard lock{job_lock};
+    // the board's totals are worked out again with this engine's weights, every
+    // position the search reaches is made from it and so uses them too.
+    next.b = b;
+    next.b.psq = b.compute_psq(weights);
+    next.game = game;
+    next.limits = limits;
+    next.gen = &gen;
+    next.on_finish = std::move(on_finish);
+    busy = true;
+  }
+
+  job_ready.notify_one();
+}
+
+auto engine::idle_loop() -> void {
+  while (true) {
+    {
+      std::unique_lock lock{job_lock};
+      job_ready.wait(lock, [this] { return busy || quit; });
+      if (quit) {
+        return;
+      }
+    }
+
+    run();
+
+    // the gui isn't expecting a best move until it has told us whether the
+    // opponent played the move we were pondering on, or until it stops an
+    // infinite search.
+    {
+      std::unique_lock lock{ponder_lock};
+      ponder_end.wait(lock, [this] { return (!pondering && !infinite) || stop_requested; });
+    }
+
+    next.on_finish(workers[0].result);
+
+    {
+      std::lock_guard lock{job_lock};
+      busy = false;
+    }
+
+    job_done.notify_all();
+  }
+}
+
+auto engine::stop() -> void {
+  {
+    std::lock_guard lock{ponder_lock};
+    stop_requested = true;
+  }
+
+  stop_flag.store(true);
+  ponder_end.notify_all();
+}
+
+auto engine::ponderhit() -> void {
+  clock.ponderhit();
+  {
+    std::lock_guard lock{ponder_lock};
+    pondering = false;
+  }
+
+  ponder_end.notify_all();
+}
+
+auto engine::wait() -> void {
+  std::unique_lock lock{job_lock};
+  job_done.wait(lock, [this] { return !busy; });
+}
+
+auto engine::search(const board &b, const std::size_t depth, std::mt19937 &gen) -> search_result {
+  search_limits limits;
+  limits.depth = depth;
+
+  search_result result;
+  start(b, key_history{}, limits, gen, [&result](const search_result &r) {
+    result = r;
+  });
+
+  wait();
+  return result;
+}
+
+auto engine::run() -> void {
+  const auto &b = next.b;
+  const auto &limits = next.limits;
+  assert(limits.depth > 0);
+
+  const auto start = std::chrono::steady_clock::now();
+  // a shared table is aged by its owner, other engines may still be using the
+  // entries of its current generation.
+  if (own_tt) {
+    tt.new_search();
+  }
+  searched.store(0, std::memory_order_relaxed);
+
+  // a mate in n moves takes 2n - 1 plies, with a couple more to spare for the
+  // reductions on the way.
+  const auto depth = limits.mate > 0 ? std::min(limits.depth, 2 * limits.mate + 1) : limits.depth;
+
+  // the node budget is split evenly, the main thread takes what is left over.
+  // every thread gets at least one node, otherwise a helper with nothing to
+  // spend would stop the search before it had started.
+  const auto unlimited = std::numeric_limits<std::uint64_t>::max();
+  const auto share = std::max<std::uint64_t>(limits.nodes / threads, 1);
+  const auto main_share = std::max<std::uint64_t>(limits.nodes, share * threads) - share * (threads - 1);
+
+  const bool tree_split = threads > 1 && parallelism == parallel_search::tree_split;
+  for (auto i = 0ul; i < threads; ++i) {
+    auto &w = workers[i];
+
+    // each helper thread orders its moves with its own random number generator.
+    if (i == 0) {
+      w.gen = next.gen;
+      w.clock = &clock;
+    } else {
+      w.own_gen.seed((*next.gen)());
+      w.gen = &w.own_gen;
+      w.clock = nullptr;
+    }
+
+    // a fixed move time is used in full rather than saved for later moves.
+    w.next_iteration = limits.movetime.count() > 0 ? 1.0 : 0.5;
+    w.node_limit = limits.nodes == 0 ? unlimited : i == 0 ? main_share : share;
+
+    w.net = eval == evaluator::nnue && network.loaded() ? &network : nullptr;
+    w.nodes = 0;
+    w.eval_hits = 0;
+    w.eval_misses = 0;
+    w.searched = &searched;
+    w.seldepth = 0;
+    w.on_info = i == 0 && on_info ? &on_info : nullptr;
+    w.start = start;
+    w.stopped = false;
+    w.history = next.game;
+    w.history.push(b.hash);
+    w.top = w.stack.get();
+    for (auto f = 0ul; f < stack_size; ++f) {
+      w.stack[f].killers = {};
+    }
+
+    w.pool = tree_split ? pool.get() : nullptr;
+    w.team = workers.data();
+    w.id = i;
+    w.split = nullptr;
+  }
+
+  auto &result = workers[0].result;
+  if (tree_split) {
+    // only the main thread iterates, the pool threads wait for the moves of
+    // split nodes to be shared out.
+    iterative_deepening(workers[0], b, 1, depth, multi_pv, limits.searchmoves);
+  } else {
+    // lazy smp: every pool thread runs its own iterative deepening until the
+    // main thread has finished. half of the helpers start a ply deeper so that
+    // they don't just repeat the work of the main thread in lockstep.
+    struct lazy_search {
+      const board &b;
+      const move_list &searchmoves;
+      search_worker *team;
+      std::atomic<std::size_t> pending{0};
+    } helpers{b, limits.searchmoves, workers.data()};
+
+    const auto run_helper = [](void *context, const std::size_t thread) {
+      auto &helpers = *static_cast<lazy_search *>(context);
+
+      // the search thread only picks up the helpers that haven't been started
+      // by the time it has finished, they aren't needed any more.
+      if (thread != 0) {
+        auto &w = helpers.team[thread];
+        iterative_deepening(w, helpers.b, 1 + thread % 2, max_depth, 1, helpers.searchmoves);
+      }
+
+      helpers.pending.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    for (auto i = 1ul; i < threads; ++i) {
+      helpers.pending.fetch_add(1, std::memory_order_relaxed);
+      if (!pool->push(0, {run_helper, &helpers})) {
+        helpers.pending.fetch_sub(1, std::memory_order_relaxed);
+        break;
+      }
+    }
+
+    iterative_deepening(workers[0], b, 1, depth, multi_pv, limits.searchmoves);
+
+    stop_flag.store(true);
+    while (helpers.pending.load(std::memory_order_acquire) > 0) {
+      if (!pool->run_one(0)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  result.nodes = 0;
+  result.eval_hits = 0;
+  result.eval_misses = 0;
+  for (const auto &w : workers) {
+    result.nodes += w.nodes;
+    result.eval_hits += w.eval_hits;
+    result.eval_misses += w.eval_misses;
+  }
+
+  result.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start);
+}
+
+} // namespace pawntificate
@@ -0,0 +1,47 @@
+#include "pawntificate/eval_cache.hpp"
+
+namespace pawntificate {
+
+namespace {
+
+// the low bits of the key pick the slot, the high bits are kept to check it.
+constexpr std::uint64_t key_mask = 0xffffffff00000000ull;
+
+} // unnamed namespace
+
+eval_cache::eval_cache(const std::size_t megabytes) {
+  // round down to a power of two so the index is a mask of the key.
+  std::size_t count = 1;
+  while (count * 2 * sizeof(std::uint64_t) <= megabytes * 1024 * 1024) {
+    count *= 2;
+  }
+
+  slots = std::make_unique<std::atomic<std::uint64_t>[]>(count);
+  mask = count - 1;
+  clear();
+}
+
+auto eval_cache::clear() -> void {
+  for (std::size_t i = 0; i <= mask; ++i) {
+    slots[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+auto eval_cache::probe(const std::uint64_t key, score &value) const -> bool {
+  const auto data = slots[key & mask].load(std::memory_order_relaxed);
+
+  // an empty slot never matches.
+  if (data == 0 || (data & key_mask) != (key & key_mask)) {
+    return false;
+  }
+
+  value = static_cast<score>(static_cast<std::int32_t>(data & ~key_mask));
+  return true;
+}
+
+auto eval_cache::store(const std::uint64_t key, const score value) -> void {
+  const auto data = (key & key_mask) | static_cast<std::uint32_t>(value);
+  slots[key & mask].store(data, std::memory_order_relaxed);
+}
+
+} // namespace pawntificate
@@ -0,0 +1,292 @@
+#include "pawntificate/nnue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace pawntificate {
+namespace nnue {
+
+namespace {
+
+// the hidden layers work in fixed point, their sums are scaled back down by
+// this many bits before being clipped. the output is scaled to centipawns.
+constexpr unsigned weight_scale_bits = 6u;
+constexpr std::int32_t output_scale = 16;
+
+// a side sees the board from its own end, so black's squares are mirrored.
+constexpr auto orient(const colour perspective, const std::size_t s) -> std::size_t {
+  return perspective == colour::white ? s : s ^ 56u;
+}
+
+constexpr auto other(const colour c) -> colour {
+  return c == colour::white ? colour::black : colour::white;
+}
+
+// the pieces other than the kings are numbered 0..10, friendly pieces first.
+constexpr auto feature(const colour perspective, const std::size_t king, const piece p, const std::size_t s)
+    -> std::size_t {
+  const auto type = static_cast<std::size_t>(p.type()) - 1;
+  const auto index = type * 2 + (p.colour() == perspective ? 0 : 1);
+  return (orient(perspective, king) * 10 + index) * 64 + orient(perspective, s);
+}
+
+constexpr auto has_feature(const piece p) -> bool {
+  return p != pieces::_ && p.type() != ptype::king;
+}
+
+auto find_king(const board &b, const colour c) -> std::size_t {
+  const piece king{c, ptype::king};
+  for (auto i = 0ul; i < b.piece_board.size(); ++i) {
+    if (b.piece_board[i] == king) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+// the kernels, with avx2 and sse4.1 versions where the compiler targets them.
+
+auto add_row(std::int16_t *acc, const std::int16_t *row) -> void {
+#if defined(__AVX2__)
+  for (auto i = 0ul; i < half_dimensions; i += 16) {
+    const auto a = _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + i));
+    const auto r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc + i), _mm256_add_epi16(a, r));
+  }
+#elif defined(__SSE4_1__)
+  for (auto i = 0ul; i < half_dimensions; i += 8) {
+    const auto a = _mm_load_si128(reinterpret_cast<const __m128i *>(acc + i));
+    const auto r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+    _mm_store_si128(reinterpret_cast<__m128i *>(acc + i), _mm_add_epi16(a, r));
+  }
+#else
+  for (auto i = 0ul; i < half_dimensions; ++i) {
+    acc[i] = static_cast<std::int16_t>(acc[i] + row[i]);
+  }
+#endif
+}
+
+auto sub_row(std::int16_t *acc, const std::int16_t *row) -> void {
+#if defined(__AVX2__)
+  for (auto i = 0ul; i < half_dimensions; i += 16) {
+    const auto a = _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + i));
+    const auto r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc + i), _mm256_sub_epi16(a, r));
+  }
+#elif defined(__SSE4_1__)
+  for (auto i = 0ul; i < half_dimensions; i += 8) {
+    const auto a = _mm_load_si128(reinterpret_cast<const __m128i *>(acc + i));
+    const auto r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+    _mm_store_si128(reinterpret_cast<__m128i *>(acc + i), _mm_sub_epi16(a, r));
+  }
+#else
+  for (auto i = 0ul; i < half_dimensions; ++i) {
+    acc[i] = static_cast<std::int16_t>(acc[i] - row[i]);
+  }
+#endif
+}
+
+// the dot product of n unsigned 8-bit inputs with signed 8-bit weights, n is a
+// multiple of 32.
+auto dot(const std::uint8_t *input, const std::int8_t *weights, const std::size_t n) -> std::int32_t {
+#if defined(__AVX2__)
+  const auto ones = _mm256_set1_epi16(1);
+  auto sum = _mm256_setzero_si256();
+  for (auto i = 0ul; i < n; i += 32) {
+    const auto in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const auto w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones));
+  }
+
+  const auto half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+  const auto quarter = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0b01001110));
+  return _mm_cvtsi128_si32(_mm_add_epi32(quarter, _mm_shuffle_epi32(quarter, 0b10110001)));
+#elif defined(__SSE4_1__)
+  const auto ones = _mm_set1_epi16(1);
+  auto sum = _mm_setzero_si128();
+  for (auto i = 0ul; i < n; i += 16) {
+    const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const auto w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(in, w), ones));
+  }
+
+  const auto half = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0b01001110));
+  return _mm_cvtsi128_si32(_mm_add_epi32(half, _mm_shuffle_epi32(half, 0b10110001)));
+#else
+  std::int32_t sum = 0;
+  for (auto i = 0ul; i < n; ++i) {
+    sum += static_cast<std::int32_t>(input[i]) * weights[i];
+  }
+
+  return sum;
+#endif
+}
+
+// a fully connected layer followed by a clipped relu.
+template <std::size_t In, std::size_t Out>
+auto hidden_layer(const std::uint8_t *input,
+                  const std::int8_t *weights,
+                  const std::int32_t *biases,
+                  std::uint8_t *output) -> void {
+  for (auto o = 0ul; o < Out; ++o) {
+    const auto sum = biases[o] + dot(input, weights + o * In, In);
+    output[o] = static_cast<std::uint8_t>(std::clamp(sum >> weight_scale_bits, 0, 127));
+  }
+}
+
+} // unnamed namespace
+
+network::~network() {
+  unmap();
+}
+
+auto network::load(const std::filesystem::path &path) -> bool {
+  unmap();
+
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st{};
+  void *m = MAP_FAILED;
+  if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == file_size) {
+    m = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+
+  // the mapping stays valid once the file is closed.
+  ::close(fd);
+  if (m == MAP_FAILED) {
+    return false;
+  }
+
+  const auto *bytes = static_cast<const char *>(m);
+  std::uint32_t header[3];
+  std::memcpy(header, bytes + magic.size(), sizeof(header));
+  if (!std::equal(std::begin(magic), std::end(magic), bytes) ||
+      header[0] != version || header[1] != half_dimensions || header[2] != hidden_dimensions) {
+    ::munmap(m, file_size);
+    return false;
+  }
+
+  mapping = m;
+
+  // walk through the sections in order.
+  auto next = bytes + header_size;
+  const auto take = [&next](const auto *&section, const std::size_t count) {
+    using T = std::remove_const_t<std::remove_reference_t<decltype(*section)>>;
+    section = reinterpret_cast<const T *>(next);
+    next += count * sizeof(T);
+  };
+
+  take(feature_biases, half_dimensions);
+  take(feature_weights, feature_count * half_dimensions);
+  take(hidden1_biases, hidden_dimensions);
+  take(hidden1_weights, hidden_dimensions * 2 * half_dimensions);
+  take(hidden2_biases, hidden_dimensions);
+  take(hidden2_weights, hidden_dimensions * hidden_dimensions);
+  take(output_bias, 1);
+  take(output_weights, hidden_dimensions);
+  return true;
+}
+
+auto network::loaded() const -> bool {
+  return mapping != nullptr;
+}
+
+auto network::unmap() -> void {
+  if (mapping != nullptr) {
+    ::munmap(mapping, file_size);
+    mapping = nullptr;
+  }
+}
+
+auto network::refresh(const board &b, const colour perspective, accumulator &acc) const -> void {
+  auto &values = acc.values[static_cast<std::size_t>(perspective)];
+  std::copy(feature_biases, feature_biases + half_dimensions, std::begin(values));
+
+  const auto king = find_king(b, perspective);
+  for (auto s = 0ul; s < b.piece_board.size(); ++s) {
+    const auto p = b.piece_board[s];
+    if (has_feature(p)) {
+      add_row(values.data(), feature_weights + feature(perspective, king, p, s) * half_dimensions);
+    }
+  }
+}
+
+auto network::refresh(const board &b, accumulator &acc) const -> void {
+  refresh(b, colour::white, acc);
+  refresh(b, colour::black, acc);
+}
+
+auto network::update(const board &parent, const accumulator &from, const board &child, accumulator &to) const
+    -> void {
+  // a move changes at most four squares (castling).
+  std::array<std::size_t, 4> changed{};
+  auto count = 0ul;
+  for (auto s = 0ul; s < parent.piece_board.size() && count < changed.size(); ++s) {
+    if (parent.piece_board[s] != child.piece_board[s]) {
+      changed[count++] = s;
+    }
+  }
+
+  for (const auto perspective : {colour::white, colour::black}) {
+    const piece king{perspective, ptype::king};
+    const auto moved = std::any_of(std::begin(changed), std::begin(changed) + count, [&](const std::size_t s) {
+      return parent.piece_board[s] == king;
+    });
+
+    // every feature depends on the king's square.
+    if (moved) {
+      refresh(child, perspective, to);
+      continue;
+    }
+
+    const auto side = static_cast<std::size_t>(perspective);
+    auto &values = to.values[side];
+    values = from.values[side];
+
+    const auto king_square = find_king(child, perspective);
+    for (auto i = 0ul; i < count; ++i) {
+      const auto s = changed[i];
+      if (has_feature(parent.piece_board[s])) {
+        sub_row(values.data(), feature_weights + feature(perspective, king_square, parent.piece_board[s], s) * half_dimensions);
+      }
+
+      if (has_feature(child.piece_board[s])) {
+        add_row(values.data(), feature_weights + feature(perspective, king_square, child.piece_board[s], s) * half_dimensions);
+      }
+    }
+  }
+}
+
+auto network::evaluate(const board &b, const accumulator &acc) const -> score {
+  // the side to move's half comes first.
+  alignas(32) std::array<std::uint8_t, 2 * half_dimensions> input;
+  const auto &us = acc.values[static_cast<std::size_t>(b.active)];
+  const auto &them = acc.values[static_cast<std::size_t>(other(b.active))];
+  for (auto i = 0ul; i < half_dimensions; ++i) {
+    input[i] = static_cast<std::uint8_t>(std::clamp<std::int16_t>(us[i], 0, 127));
+    input[half_dimensions + i] = static_cast<std::uint8_t>(std::clamp<std::int16_t>(them[i], 0, 127));
+  }
+
+  alignas(32) std::array<std::uint8_t, hidden_dimensions> hidden1;
+  alignas(32) std::array<std::uint8_t, hidden_dimensions> hidden2;
+  hidden_layer<2 * half_dimensions, hidden_dimensions>(input.data(), hidden1_weights, hidden1_biases, hidden1.data());
+  hidden_layer<hidden_dimensions, hidden_dimensions>(hidden1.data(), hidden2_weights, hidden2_biases, hidden2.data());
+
+  return (*output_bias + dot(hidden2.data(), output_weights, hidden_dimensions)) / output_scale;
+}
+
+} // namespace nnue
+} // namespace pawntificate
@@ -0,0 +1,174 @@
+#include "pawntificate/pawns.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace pawntificate {
+
+namespace {
+
+// bonuses for a passed pawn by how far it has advanced, and penalties for
+// the weaknesses. middlegame first, then endgame.
+constexpr std::array<std::int32_t, 8> passed_mg{0, 5, 10, 15, 30, 50, 80, 0};
+constexpr std::array<std::int32_t, 8> passed_eg{0, 10, 15, 25, 45, 75, 120, 0};
+constexpr std::int32_t isolated_mg = -10;
+constexpr std::int32_t isolated_eg = -15;
+constexpr std::int32_t doubled_mg = -10;
+constexpr std::int32_t doubled_eg = -25;
+constexpr std::int32_t backward_mg = -8;
+constexpr std::int32_t backward_eg = -12;
+
+constexpr auto bit(const std::size_t s) -> std::uint64_t {
+  return 1ull << s;
+}
+
+constexpr std::uint64_t file_a = 0x0101010101010101ull;
+constexpr std::uint64_t file_h = file_a << 7u;
+
+struct span_table {
+  // indexed by colour and then square, bits set on the squares in front of a
+  // pawn (from its side's point of view) on its own file, and on its own and
+  // the adjacent files.
+  std::array<std::array<std::uint64_t, 64>, 2> front{};
+  std::array<std::array<std::uint64_t, 64>, 2> passed{};
+
+  // indexed by colour and then square, the squares on the adjacent files that
+  // are level with or behind a pawn, where a pawn that could support it is.
+  std::array<std::array<std::uint64_t, 64>, 2> support{};
+
+  // indexed by file.
+  std::array<std::uint64_t, 8> adjacent{};
+};
+
+constexpr span_table spans = [] {
+  span_table t;
+  for (auto f = 0u; f < 8u; ++f) {
+    t.adjacent[f] = (f > 0 ? file_a << (f - 1) : 0ull) | (f < 7 ? file_a << (f + 1) : 0ull);
+  }
+
+  for (auto s = 0u; s < 64u; ++s) {
+    const auto f = s % 8;
+    const auto r = s / 8;
+    for (auto other = 0u; other < 64u; ++other) {
+      const auto of = other % 8;
+      const auto o = other / 8;
+      const bool same_file = of == f;
+      const bool adjacent_file = (t.adjacent[f] & bit(other)) != 0;
+
+      // black is index 0, white is 1.
+      for (auto c = 0u; c < 2u; ++c) {
+        const bool ahead = c == 1 ? o > r : o < r;
+        if (ahead && same_file) {
+          t.front[c][s] |= bit(other);
+        }
+
+        if (ahead && (same_file || adjacent_file)) {
+          t.passed[c][s] |= bit(other);
+        }
+
+        if (!ahead && adjacent_file) {
+          t.support[c][s] |= bit(other);
+        }
+      }
+    }
+  }
+
+  return t;
+}();
+
+} // unnamed namespace
+
+auto evaluate_pawns(const board &b) -> pawn_entry {
+  pawn_entry e;
+  e.key = b.pawn_hash;
+
+  // indexed by colour like the spans.
+  std::array<std::uint64_t, 2> pawns{};
+  for (auto s = 0ul; s < b.piece_board.size(); ++s) {
+    const auto p = b.piece_board[s];
+    if (is_pawn(p)) {
+      pawns[static_cast<std::size_t>(p.colour())] |= bit(s);
+    }
+  }
+
+  // the squares each side's pawns attack.
+  const auto white = pawns[1];
+  const auto black = pawns[0];
+  const std::array<std::uint64_t, 2> attacks{
+    ((black & ~file_h) >> 7u) | ((black & ~file_a) >> 9u),
+    ((white & ~file_a) << 7u) | ((white & ~file_h) << 9u)
+  };
+
+  for (auto s = 0ul; s < b.piece_board.size(); ++s) {
+    const auto p = b.piece_board[s];
+    if (!is_pawn(p)) {
+      continue;
+    }
+
+    const auto c = static_cast<std::size_t>(p.colour());
+    const auto them = 1 - c;
+    const auto own = pawns[c];
+    const auto sign = c == 1 ? 1 : -1;
+    std::int32_t mg = 0;
+    std::int32_t eg = 0;
+
+    // ranks counted from the pawn's own side of the board.
+    const auto relative_rank = c == 1 ? s / 8 : 7 - s / 8;
+
+    if ((spans.passed[c][s] & pawns[them]) == 0) {
+      e.passed[c] |= bit(s);
+      mg += passed_mg[relative_rank];
+      eg += passed_eg[relative_rank];
+    }
+
+    // every pawn with one of its own in front of it counts as doubled.
+    if ((spans.front[c][s] & own) != 0) {
+      mg += doubled_mg;
+      eg += doubled_eg;
+    }
+
+    if ((spans.adjacent[s % 8] & own) == 0) {
+      mg += isolated_mg;
+      eg += isolated_eg;
+    } else if ((spans.support[c][s] & own) == 0) {
+      // nothing can come up to support it and it can't advance without being
+      // taken.
+      const auto stop = c == 1 ? s + 8 : s - 8;
+      if ((attacks[them] & bit(stop)) != 0) {
+        mg += backward_mg;
+        eg += backward_eg;
+      }
+    }
+
+    e.mg += sign * mg;
+    e.eg += sign * eg;
+  }
+
+  return e;
+}
+
+pawn_table::pawn_table(const std::size_t size)
+: mask{size - 1}, entries{std::make_unique<pawn_entry[]>(size)} {
+  // the index is a mask of the key.
+  assert(size > 0 && (size & mask) == 0);
+}
+
+auto pawn_table::probe(const board &b) -> const pawn_entry & {
+  auto &e = entries[b.pawn_hash & mask];
+  if (e.key == b.pawn_hash) {
+    ++hit_count;
+  } else {
+    ++miss_count;
+    e = evaluate_pawns(b);
+  }
+
+  return e;
+}
+
+auto pawn_table::clear() -> void {
+  std::fill(entries.get(), entries.get() + mask + 1, pawn_entry{});
+  hit_count = 0;
+  miss_count = 0;
+}
+
+} // namespace pawntificate
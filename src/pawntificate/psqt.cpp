@@ -0,0 +1,103 @@
+#include "pawntificate/psqt.hpp"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace pawntificate {
+namespace psqt {
+
+namespace {
+
+// the raw tables are named after their piece type, there is none for index 0.
+constexpr std::array<const char *, 7> type_names{"", "pawn", "knight", "bishop", "rook", "queen", "king"};
+
+// every table in the file by name, with where its values go.
+template <typename Params, typename F>
+auto for_each_table(Params &params, F &&f) -> void {
+  f(std::string{"mg_value"}, std::span{params.mg_value});
+  f(std::string{"eg_value"}, std::span{params.eg_value});
+  for (auto t = 1ul; t < type_names.size(); ++t) {
+    f("mg_" + std::string{type_names[t]}, std::span{params.mg_raw[t]});
+    f("eg_" + std::string{type_names[t]}, std::span{params.eg_raw[t]});
+  }
+}
+
+} // unnamed namespace
+
+auto load_parameters(const std::filesystem::path &path, parameters &params) -> bool {
+  std::ifstream in{path};
+  if (!in) {
+    return false;
+  }
+
+  // read the tables into a copy so that a bad file changes nothing.
+  auto loaded = params;
+  std::uint64_t found = 0;
+  std::uint64_t expected = 0;
+  std::size_t tables = 0;
+  for_each_table(loaded, [&](const auto &, auto) { expected |= 1ull << tables++; });
+
+  for (std::string line; std::getline(in, line);) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream fields{line};
+    std::string name;
+    fields >> name;
+
+    bool valid = true;
+    std::uint64_t table_bit = 0;
+    tables = 0;
+    for_each_table(loaded, [&](const std::string &table, const auto values) {
+      const auto bit = 1ull << tables++;
+      if (table != name) {
+        return;
+      }
+
+      table_bit = bit;
+      using limits = std::numeric_limits<std::int16_t>;
+      for (auto &v : values) {
+        int value = 0;
+        valid = valid && static_cast<bool>(fields >> value) && value >= limits::min() && value <= limits::max();
+        v = static_cast<std::int16_t>(value);
+      }
+
+      std::string extra;
+      valid = valid && !(fields >> extra);
+    });
+
+    // each table must appear exactly once.
+    if (table_bit == 0 || (found & table_bit) != 0 || !valid) {
+      return false;
+    }
+
+    found |= table_bit;
+  }
+
+  if (found != expected) {
+    return false;
+  }
+
+  params = loaded;
+  return true;
+}
+
+auto save_parameters(const std::filesystem::path &path, const parameters &params) -> bool {
+  std::ofstream out{path};
+  out << "# pawntificate evaluation parameters, the raw tables start from a8\n";
+  for_each_table(params, [&out](const std::string &name, const auto values) {
+    out << name;
+    for (const auto v : values) {
+      out << ' ' << v;
+    }
+    out << '\n';
+  });
+
+  return static_cast<bool>(out.flush());
+}
+
+} // namespace psqt
+} // namespace pawntificate
@@ -0,0 +1,74 @@
+#include "pawntificate/quiesce.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace pawntificate {
+
+namespace {
+
+struct quiesce_search {
+  pawn_table &pawns;
+
+  // a buffer of moves per ply so the search never allocates.
+  std::array<move_list, max_quiesce_depth + 1> moves;
+
+  auto search(const board &b, score alpha, const score beta, const std::size_t ply, board &leaf) -> score {
+    auto &list = moves[ply];
+    find_legal_moves(b, list);
+    if (list.empty()) {
+      leaf = b;
+      return in_check(b) ? static_cast<score>(ply) - mate : 0;
+    }
+
+    // standing pat: the side to move doesn't have to capture anything.
+    const auto stand_pat = evaluate_position(b, pawns);
+    leaf = b;
+    if (stand_pat >= beta || ply == max_quiesce_depth) {
+      return stand_pat;
+    }
+    alpha = std::max(alpha, stand_pat);
+
+    // only the captures and promotions, most valuable victim first and then
+    // least valuable attacker.
+    const auto noisy = std::partition(std::begin(list), std::end(list), [](const move m) {
+      return m.killer() || m.promote_to() != ptype::_;
+    });
+
+    const auto gain = [&b](const move m) {
+      const auto victim = static_cast<int>(b.piece_board[static_cast<std::size_t>(m.to())].type());
+      const auto attacker = static_cast<int>(b.piece_board[static_cast<std::size_t>(m.from())].type());
+      return victim * 8 - attacker + static_cast<int>(m.promote_to()) * 8;
+    };
+
+    std::sort(std::begin(list), noisy, [&gain](const move lhs, const move rhs) {
+      return gain(lhs) > gain(rhs);
+    });
+
+    board child_leaf;
+    for (auto m = std::begin(list); m != noisy; ++m) {
+      const board child{b, *m};
+      const auto value = -search(child, -beta, -alpha, ply + 1, child_leaf);
+      if (value > alpha) {
+        alpha = value;
+        leaf = child_leaf;
+        if (alpha >= beta) {
+          break;
+        }
+      }
+    }
+
+    return alpha;
+  }
+};
+
+} // unnamed namespace
+
+auto quiesce(const board &b, pawn_table &pawns) -> quiesce_result {
+  quiesce_search s{pawns, {}};
+  quiesce_result result;
+  result.value = s.search(b, -mate, mate, 0, result.leaf);
+  return result;
+}
+
+} // namespace pawntificate
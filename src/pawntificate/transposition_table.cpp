@@ -0,0 +1,125 @@
+#include "pawntificate/transposition_table.hpp"
+
+#include <algorithm>
+
+namespace pawntificate {
+
+namespace {
+
+// an entry is packed into 64-bits:
+//  [0..16)  best move
+//  [16..48) score
+//  [48..56) depth
+//  [56..58) bound
+//  [58..64) generation
+constexpr auto pack(const transposition &entry, const std::uint8_t generation) -> std::uint64_t {
+  return static_cast<std::uint64_t>(entry.best.bits()) |
+         static_cast<std::uint64_t>(static_cast<std::uint32_t>(entry.value)) << 16u |
+         static_cast<std::uint64_t>(entry.depth) << 48u |
+         static_cast<std::uint64_t>(entry.type) << 56u |
+         static_cast<std::uint64_t>(generation & 0b111111u) << 58u;
+}
+
+constexpr auto unpack(const std::uint64_t data) -> transposition {
+  return {
+    move::from_bits(static_cast<std::uint16_t>(data)),
+    static_cast<score>(static_cast<std::uint32_t>(data >> 16u)),
+    static_cast<std::uint8_t>(data >> 48u),
+    static_cast<bound>((data >> 56u) & 0b11u)
+  };
+}
+
+constexpr auto generation_of(const std::uint64_t data) -> std::uint8_t {
+  return static_cast<std::uint8_t>(data >> 58u);
+}
+
+static_assert(unpack(pack({move{square::e2, square::e4}, -42, 7, bound::lower}, 3)).value == -42);
+static_assert(unpack(pack({move{square::e2, square::e4}, -42, 7, bound::lower}, 3)).depth == 7);
+static_assert(unpack(pack({move{square::e2, square::e4}, -42, 7, bound::lower}, 3)).type == bound::lower);
+static_assert(unpack(pack({move{square::e2, square::e4}, -42, 7, bound::lower}, 3)).best ==
+              move(square::e2, square::e4));
+
+} // unnamed namespace
+
+transposition_table::transposition_table(const std::size_t megabytes) {
+  resize(megabytes);
+}
+
+auto transposition_table::resize(const std::size_t megabytes) -> void {
+  // round down to a power of two so the index is a mask of the key.
+  std::size_t count = 1;
+  while (count * 2 * sizeof(slot) <= megabytes * 1024 * 1024) {
+    count *= 2;
+  }
+
+  slots = std::make_unique<slot[]>(count);
+  mask = count - 1;
+  clear();
+}
+
+auto transposition_table::clear() -> void {
+  for (std::size_t i = 0; i <= mask; ++i) {
+    slots[i].check.store(0, std::memory_order_relaxed);
+    slots[i].data.store(0, std::memory_order_relaxed);
+  }
+
+  generation.store(0, std::memory_order_relaxed);
+}
+
+auto transposition_table::current_generation() const -> std::uint8_t {
+  return static_cast<std::uint8_t>(generation.load(std::memory_order_relaxed) & 0b111111u);
+}
+
+auto transposition_table::new_search() -> void {
+  // only the low bits are stored with an entry, and those wrap around with it.
+  generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto transposition_table::probe(const std::uint64_t key, transposition &entry) const -> bool {
+  const auto &s = slots[key & mask];
+  const auto data = s.data.load(std::memory_order_relaxed);
+  const auto check = s.check.load(std::memory_order_relaxed);
+
+  // an empty slot has no data so can never match a real key.
+  if (data == 0 || (check ^ data) != key) {
+    return false;
+  }
+
+  entry = unpack(data);
+  return true;
+}
+
+auto transposition_table::store(const std::uint64_t key, const transposition &entry) -> void {
+  auto &s = slots[key & mask];
+  const auto old_data = s.data.load(std::memory_order_relaxed);
+  const auto old_check = s.check.load(std::memory_order_relaxed);
+
+  // prefer to keep deeper entries of the same position from the current search,
+  // anything else is replaced.
+  const auto g = current_generation();
+  const bool same_position = (old_check ^ old_data) == key;
+  if (same_position && generation_of(old_data) == g &&
+      unpack(old_data).depth > entry.depth && entry.type != bound::exact) {
+    return;
+  }
+
+  const auto data = pack(entry, g);
+  s.check.store(key ^ data, std::memory_order_relaxed);
+  s.data.store(data, std::memory_order_relaxed);
+}
+
+auto transposition_table::hashfull() const -> std::size_t {
+  const auto g = current_generation();
+  const auto sample = std::min(mask + 1, 1000ul);
+  std::size_t used = 0;
+  for (std::size_t i = 0; i < sample; ++i) {
+    const auto data = slots[i].data.load(std::memory_order_relaxed);
+    if (data != 0 && generation_of(data) == g) {
+      ++used;
+    }
+  }
+
+  return used * 1000 / sample;
+}
+
+} // namespace pawntificate
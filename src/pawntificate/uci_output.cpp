@@ -0,0 +1,234 @@
+#include "pawntificate/uci_output.hpp"
+
+#include <charconv>
+#include <cstdlib>
+
+namespace pawntificate {
+
+namespace {
+
+// room for a few lines with a full principal variation each, and the most that
+// is ever waiting to be written.
+constexpr std::size_t buffer_size = 64ul * 1024ul;
+
+auto append(std::string &out, const std::uint64_t value) -> void {
+  char digits[24];
+  out.append(digits, std::to_chars(std::begin(digits), std::end(digits), value).ptr);
+}
+
+auto append(std::string &out, const std::int64_t value) -> void {
+  char digits[24];
+  out.append(digits, std::to_chars(std::begin(digits), std::end(digits), value).ptr);
+}
+
+auto append(std::string &out, const square s) -> void {
+  const auto index = static_cast<std::uint8_t>(s);
+  out += static_cast<char>('a' + index % 8);
+  out += static_cast<char>('1' + index / 8);
+}
+
+auto append(std::string &out, const move m) -> void {
+  append(out, m.from());
+  append(out, m.to());
+  if (m.promote_to() != ptype::_) {
+    // UCI prints promotion in lower-case.
+    out += " pnbrqk"[static_cast<std::size_t>(m.promote_to())];
+  }
+}
+
+// mates are given in moves rather than plies, negative if we are being mated.
+auto append_score(std::string &out, const score value) -> void {
+  if (is_mate(value)) {
+    const auto plies = mate - std::abs(value);
+    out += " score mate ";
+    append(out, static_cast<std::int64_t>(value > 0 ? (plies + 1) / 2 : -(plies / 2)));
+  } else {
+    out += " score cp ";
+    append(out, static_cast<std::int64_t>(value));
+  }
+}
+
+auto append_pv(std::string &out, const principal_variation &pv) -> void {
+  out += " pv";
+  for (const auto m : pv.moves) {
+    out += ' ';
+    append(out, m);
+  }
+}
+
+} // unnamed namespace
+
+uci_output::uci_output(std::ostream &os, const std::chrono::milliseconds interval)
+: os{os}, interval{interval.count()} {
+  line.reserve(buffer_size);
+  pending.reserve(buffer_size);
+  writing.reserve(buffer_size);
+  writer = std::thread([this] { writer_loop(); });
+}
+
+uci_output::~uci_output() {
+  {
+    std::lock_guard guard{lock};
+    done = true;
+  }
+
+  ready.notify_one();
+  writer.join();
+}
+
+auto uci_output::set_interval(const std::chrono::milliseconds i) -> void {
+  interval.store(i.count(), std::memory_order_relaxed);
+}
+
+auto uci_output::write(const std::string_view text) -> void {
+  {
+    std::lock_guard guard{lock};
+    pending.append(text);
+  }
+
+  ready.notify_one();
+}
+
+auto uci_output::info(const search_info &info) -> void {
+  line.clear();
+  if (info.lines.empty()) {
+    const auto since = info.time < last_progress ? info.time : info.time - last_progress;
+    if (since.count() < interval.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    line += "info depth ";
+    append(line, static_cast<std::uint64_t>(info.depth));
+    line += " currmove ";
+    append(line, info.currmove);
+    line += " currmovenumber ";
+    append(line, static_cast<std::uint64_t>(info.currmovenumber));
+    line += " nodes ";
+    append(line, info.nodes);
+    line += " nps ";
+    append(line, info.nps());
+    line += " time ";
+    append(line, static_cast<std::int64_t>(info.time.count()));
+    line += '\n';
+
+    if (queue(urgency::progress)) {
+      last_progress = info.time;
+    }
+
+    return;
+  }
+
+  for (auto i = 0ul; i < info.lines.size(); ++i) {
+    line += "info depth ";
+    append(line, static_cast<std::uint64_t>(info.depth));
+    line += " seldepth ";
+    append(line, static_cast<std::uint64_t>(info.seldepth));
+    line += " multipv ";
+    append(line, static_cast<std::uint64_t>(i + 1));
+    append_score(line, info.lines[i].value);
+    line += " nodes ";
+    append(line, info.nodes);
+    line += " nps ";
+    append(line, info.nps());
+    line += " hashfull ";
+    append(line, static_cast<std::uint64_t>(info.hashfull));
+    line += " time ";
+    append(line, static_cast<std::int64_t>(info.time.count()));
+    append_pv(line, info.lines[i]);
+    line += '\n';
+  }
+
+  // a completed iteration counts as an update.
+  if (queue(urgency::iteration)) {
+    last_progress = info.time;
+  }
+}
+
+auto uci_output::result(const search_result &result) -> void {
+  line.clear();
+  for (auto i = 0ul; i < result.lines.size(); ++i) {
+    line += "info multipv ";
+    append(line, static_cast<std::uint64_t>(i + 1));
+    line += " depth ";
+    append(line, static_cast<std::uint64_t>(result.depth));
+    append_score(line, result.lines[i].value);
+    line += " nodes ";
+    append(line, result.nodes);
+    line += " nps ";
+    append(line, result.nps());
+    line += " time ";
+    append(line, static_cast<std::int64_t>(result.time.count()));
+    append_pv(line, result.lines[i]);
+    line += '\n';
+  }
+
+  // the second move of the principal variation is the reply we expect, the gui
+  // may ask us to ponder on it.
+  line += "bestmove ";
+  append(line, result.best);
+  if (!result.lines.empty() && result.lines[0].moves.size() > 1) {
+    line += " ponder ";
+    append(line, result.lines[0].moves[1]);
+  }
+
+  line += '\n';
+  queue(urgency::result);
+
+  // the next search starts its clock from zero.
+  last_progress = {};
+}
+
+auto uci_output::flush() -> void {
+  std::unique_lock guard{lock};
+  written.wait(guard, [this] { return pending.empty() && !busy; });
+}
+
+auto uci_output::queue(const urgency u) -> bool {
+  {
+    std::unique_lock guard{lock, std::defer_lock};
+    if (u != urgency::progress) {
+      guard.lock();
+    } else if (!guard.try_lock()) {
+      return false;
+    }
+
+    const auto fits = [this] { return pending.empty() || pending.size() + line.size() <= buffer_size; };
+    if (u == urgency::result) {
+      // the gui is waiting on the best move, it can't be dropped.
+      written.wait(guard, fits);
+    } else if (!fits()) {
+      return false;
+    }
+
+    pending.append(line);
+  }
+
+  ready.notify_one();
+  return true;
+}
+
+auto uci_output::writer_loop() -> void {
+  std::unique_lock guard{lock};
+  while (true) {
+    ready.wait(guard, [this] { return !pending.empty() || done; });
+    if (pending.empty()) {
+      return;
+    }
+
+    // swap the buffers so more can be queued while this lot is written.
+    writing.swap(pending);
+    busy = true;
+    guard.unlock();
+    written.notify_all();
+
+    os.write(writing.data(), static_cast<std::streamsize>(writing.size()));
+    os.flush();
+    writing.clear();
+
+    guard.lock();
+    busy = false;
+    written.notify_all();
+  }
+}
+
+} // namespace pawntificate
@@ -0,0 +1,43 @@
+#include "pawntificate/uci_position.hpp"
+
+namespace pawntificate {
+
+auto uci_position::set(const std::string_view fen, std::string_view moves) -> bool {
+  // the moves carry on from the last ones if they are the same up to a move
+  // boundary.
+  const bool same_start = fen == start;
+  const bool extends = moves.substr(0, played.size()) == played &&
+    (played.empty() || moves.size() == played.size() || moves[played.size()] == ' ');
+
+  if (same_start && extends) {
+    moves.remove_prefix(played.size());
+    while (!moves.empty() && moves.front() == ' ') {
+      moves.remove_prefix(1);
+    }
+
+    if (!moves.empty()) {
+      if (!played.empty()) {
+        played += ' ';
+      }
+      played += moves;
+    }
+  } else {
+    board b;
+    if (!fen.empty() && !parse_fen(fen, b)) {
+      return false;
+    }
+
+    start = fen;
+    played = moves;
+    current = b;
+    keys.clear();
+  }
+
+  current.play(moves, [this](const board &b) {
+    keys.push(b.hash);
+  });
+
+  return true;
+}
+
+} // namespace pawntificate
@@ -0,0 +1,95 @@
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <pawntificate/batch.hpp>
+#include <pawntificate/board.hpp>
+#include <pawntificate/engine.hpp>
+#include <pawntificate/evaluate.hpp>
+
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+namespace {
+
+// the positions along a few random games.
+auto random_positions(const std::size_t count) -> std::vector<pawntificate::board> {
+  std::mt19937 gen{3};
+  std::vector<pawntificate::board> boards;
+
+  pawntificate::board b;
+  while (boards.size() < count) {
+    const auto moves = pawntificate::find_legal_moves(b);
+    if (moves.empty() || b.halfmove >= 100) {
+      b = pawntificate::board{};
+      continue;
+    }
+
+    b = pawntificate::board{b, moves[std::uniform_int_distribution<std::size_t>{0, moves.size() - 1}(gen)]};
+    boards.push_back(b);
+  }
+
+  return boards;
+}
+
+} // unnamed namespace
+
+TEST(EvaluationColumns, MatchEvaluatePosition) {
+  const auto boards = random_positions(500);
+
+  pawntificate::pawn_table pawns;
+  pawntificate::evaluation_columns columns;
+  pawntificate::gather(boards, pawns, columns);
+  ASSERT_EQ(columns.size(), boards.size());
+
+  std::vector<pawntificate::score> scores(boards.size());
+  pawntificate::evaluate_columns(columns, scores);
+  for (auto i = 0ul; i < boards.size(); ++i) {
+    ASSERT_EQ(scores[i], pawntificate::evaluate_position(boards[i])) << i;
+  }
+}
+
+class EvaluatePositions : public TestWithParam<std::size_t> {};
+
+TEST_P(EvaluatePositions, MatchEvaluatePosition) {
+  const auto boards = random_positions(10000);
+
+  std::vector<pawntificate::score> scores(boards.size());
+  pawntificate::evaluate_positions(boards, scores, GetParam());
+  for (auto i = 0ul; i < boards.size(); ++i) {
+    ASSERT_EQ(scores[i], pawntificate::evaluate_position(boards[i])) << i;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Threads, EvaluatePositions, Values(0ul, 1ul, 3ul));
+
+TEST(SearchPositions, Mates) {
+  const std::vector<pawntificate::board> boards{
+    // scholar's mate, then after it's been played.
+    pawntificate::board("e2e4 e7e5 d1f3 b8c6 f1c4 f8c5"),
+    pawntificate::board("e2e4 e7e5 d1f3 b8c6 f1c4 f8c5 f3f7"),
+    // fool's mate for black.
+    pawntificate::board("f2f3 e7e5 g2g4")
+  };
+
+  std::vector<pawntificate::score> scores(boards.size());
+  pawntificate::search_positions(boards, 2, scores, 2);
+  ASSERT_EQ(scores[0], pawntificate::mate - 1);
+  ASSERT_EQ(scores[1], -pawntificate::mate);
+  ASSERT_EQ(scores[2], pawntificate::mate - 1);
+}
+
+TEST(SearchPositions, MatchEngine) {
+  const auto boards = random_positions(20);
+
+  std::vector<pawntificate::score> scores(boards.size());
+  pawntificate::search_positions(boards, 1, scores, 1);
+
+  // at depth one the transposition table can't change anything.
+  pawntificate::engine e;
+  std::mt19937 gen;
+  for (auto i = 0ul; i < boards.size(); ++i) {
+    ASSERT_EQ(scores[i], e.search(boards[i], 1, gen).value) << i;
+  }
+}
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <pawntificate/bench.hpp>
+#include <pawntificate/board.hpp>
+
+TEST(Bench, PositionsHaveMoves) {
+  for (const auto fen : pawntificate::bench_positions) {
+    pawntificate::board b;
+    ASSERT_TRUE(pawntificate::parse_fen(fen, b)) << fen;
+
+    pawntificate::move_list moves;
+    pawntificate::find_legal_moves(b, moves);
+    ASSERT_FALSE(moves.empty()) << fen;
+  }
+}
+
+TEST(Bench, NodesAreASignature) {
+  pawntificate::engine engine;
+
+  std::size_t positions = 0;
+  const auto first = pawntificate::bench(engine, 3, [&](const std::size_t i, const auto &result) {
+    ASSERT_EQ(i, positions++);
+    ASSERT_EQ(result.depth, 3u);
+  });
+
+  ASSERT_EQ(positions, pawntificate::bench_positions.size());
+  ASSERT_GT(first.nodes, 0u);
+
+  // the same again, with an engine that has already searched them and a new
+  // one.
+  ASSERT_EQ(pawntificate::bench(engine, 3).nodes, first.nodes);
+
+  pawntificate::engine other;
+  ASSERT_EQ(pawntificate::bench(other, 3).nodes, first.nodes);
+}
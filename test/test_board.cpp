@@ -1,3 +1,6 @@
+#include <sstream>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <pawntificate/board.hpp>
@@ -223,6 +226,188 @@ TEST(BoardState, LoseCastlingLongRights) {
   }, castle::white_short | castle::black_short));
 }
 
+TEST(BoardState, HalfmoveClock) {
+  ASSERT_EQ(pawntificate::board{}.halfmove, 0u);
+  ASSERT_EQ(pawntificate::board("g1f3").halfmove, 1u);
+  ASSERT_EQ(pawntificate::board("g1f3 g8f6 f3g1").halfmove, 3u);
+
+  // pawn moves and captures reset the clock.
+  ASSERT_EQ(pawntificate::board("g1f3 g8f6 e2e4").halfmove, 0u);
+  ASSERT_EQ(pawntificate::board("g1f3 e7e5 b1c3 f8a3 b2a3").halfmove, 0u);
+  ASSERT_EQ(pawntificate::board("g1f3 e7e5 b1c3 f8a3 c3e4").halfmove, 3u);
+  ASSERT_EQ(pawntificate::board("g1f3 e7e5 f3e5").halfmove, 0u);
+}
+
+TEST(BoardState, FullmoveCounter) {
+  ASSERT_EQ(pawntificate::board{}.fullmove, 1u);
+  ASSERT_EQ(pawntificate::board("e2e4").fullmove, 1u);
+  ASSERT_EQ(pawntificate::board("e2e4 e7e5").fullmove, 2u);
+  ASSERT_EQ(pawntificate::board("e2e4 e7e5 g1f3").fullmove, 2u);
+}
+
+TEST(BoardState, Play) {
+  pawntificate::board uut;
+  std::vector<std::uint64_t> keys;
+  uut.play("e2e4 e7e5 g1f3", [&](const pawntificate::board &b) {
+    keys.push_back(b.hash);
+  });
+
+  ASSERT_EQ(uut, pawntificate::board("e2e4 e7e5 g1f3"));
+  ASSERT_EQ(keys, std::vector<std::uint64_t>({
+    pawntificate::board{}.hash,
+    pawntificate::board("e2e4").hash,
+    pawntificate::board("e2e4 e7e5").hash
+  }));
+}
+
+TEST(BoardHash, DefaultConstructed) {
+  constexpr pawntificate::board uut;
+  static_assert(uut.hash == uut.compute_hash());
+  ASSERT_NE(uut.hash, 0u);
+}
+
+TEST(BoardHash, IncrementalMatchesScratch) {
+  // castling, en passant, captures and a promotion. every field the board keeps
+  // up to date as moves are made matches the same position set up directly.
+  pawntificate::board uut("e2e4 d7d5 e4d5 c7c5 d5c6 g8f6 c6b7 e7e6 b7a8q f8e7 g1f3 e8g8");
+  const pawntificate::board scratch(uut.active, uut.piece_board, uut.castling, uut.en_passant);
+  ASSERT_EQ(uut.hash, uut.compute_hash());
+  ASSERT_EQ(uut.hash, scratch.hash);
+  ASSERT_EQ(uut.pawn_hash, uut.compute_pawn_hash());
+  ASSERT_EQ(uut.pawn_hash, scratch.pawn_hash);
+  ASSERT_EQ(uut.psq, uut.compute_psq());
+  ASSERT_EQ(uut.psq, scratch.psq);
+}
+
+TEST(BoardHash, Transposition) {
+  pawntificate::board uut1("g1f3 g8f6 b1c3 b8c6");
+  pawntificate::board uut2("b1c3 b8c6 g1f3 g8f6");
+  ASSERT_EQ(uut1.hash, uut2.hash);
+}
+
+TEST(BoardHash, SideToMove) {
+  pawntificate::board uut1("g1f3 g8f6 f3g1 f6g8");
+  pawntificate::board uut2("g1f3 g8f6 f3g1");
+  ASSERT_EQ(uut1.hash, pawntificate::board{}.hash);
+  ASSERT_NE(uut1.hash, uut2.hash);
+}
+
+TEST(BoardHash, EnPassantSquare) {
+  // same pieces and side to move but only the second has an en passant square.
+  pawntificate::board uut1("e2e3 a7a6 e3e4 a6a5");
+  pawntificate::board uut2("e2e4 a7a5");
+  ASSERT_EQ(uut1.piece_board, uut2.piece_board);
+  ASSERT_NE(uut1.hash, uut2.hash);
+}
+
+TEST(BoardPawnHash, OnlyPawns) {
+  pawntificate::board uut1("e2e4 e7e5");
+  pawntificate::board uut2("e2e4 e7e5 g1f3 b8c6");
+  pawntificate::board uut3("e2e4 e7e5 d2d3");
+  ASSERT_EQ(uut1.pawn_hash, uut2.pawn_hash);
+  ASSERT_NE(uut1.hash, uut2.hash);
+  ASSERT_NE(uut1.pawn_hash, uut3.pawn_hash);
+}
+
+TEST(BoardPsq, DefaultConstructed) {
+  constexpr pawntificate::board uut;
+  static_assert(uut.psq == uut.compute_psq());
+  ASSERT_EQ(uut.psq.phase, pawntificate::psqt::max_phase);
+
+  // the start position is symmetrical.
+  ASSERT_EQ(uut.psq.mg, 0);
+  ASSERT_EQ(uut.psq.eg, 0);
+}
+
+TEST(BoardPsq, Phase) {
+  // a knight each and then a queen each are traded.
+  ASSERT_EQ(pawntificate::board("g1f3 g8f6 f3e5 f6e4 e5d7 e4d2").psq.phase, 24);
+  ASSERT_EQ(pawntificate::board("g1f3 g8f6 f3e5 f6e4 e5d7 e4d2 d7b8 d2b1").psq.phase, 22);
+  ASSERT_EQ(pawntificate::board("e2e4 d7d5 e4d5 d8d5 d1g4 c8g4").psq.phase, 20);
+}
+
+TEST(BoardPsq, BatchBlend) {
+  const std::array<pawntificate::board, 3> boards{
+    pawntificate::board{},
+    pawntificate::board("e2e4 d7d5 e4d5 d8d5 d1g4 c8g4"),
+    pawntificate::board("e2e4 d7d5 e4d5 c7c5 d5c6 g8f6 c6b7 e7e6 b7a8q f8e7 g1f3 e8g8")
+  };
+
+  pawntificate::psqt::batch<4> uut;
+  for (auto i = 0ul; i < boards.size(); ++i) {
+    uut.mg[i] = boards[i].psq.mg;
+    uut.eg[i] = boards[i].psq.eg;
+    uut.phase[i] = boards[i].psq.phase;
+  }
+
+  std::array<std::int32_t, 4> result;
+  pawntificate::psqt::blend(uut, boards.size(), result);
+  for (auto i = 0ul; i < boards.size(); ++i) {
+    ASSERT_EQ(result[i], boards[i].psq.blend());
+  }
+}
+
+TEST(BoardFen, StartPosition) {
+  pawntificate::board uut("e2e4");
+  ASSERT_TRUE(pawntificate::parse_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", uut));
+  ASSERT_EQ(uut, pawntificate::board{});
+  ASSERT_EQ(uut.hash, pawntificate::board{}.hash);
+  ASSERT_EQ(uut.pawn_hash, pawntificate::board{}.pawn_hash);
+  ASSERT_EQ(uut.psq, pawntificate::board{}.psq);
+}
+
+TEST(BoardFen, MatchesMoves) {
+  const pawntificate::board expected("e2e4 g8f6 e4e5 d7d5 g1f3 c8g4");
+
+  pawntificate::board uut;
+  ASSERT_TRUE(pawntificate::parse_fen("rn1qkb1r/ppp1pppp/5n2/3pP3/6b1/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 4", uut));
+  ASSERT_EQ(uut, expected);
+  ASSERT_EQ(uut.hash, expected.hash);
+  ASSERT_EQ(uut.pawn_hash, expected.pawn_hash);
+  ASSERT_EQ(uut.psq, expected.psq);
+  ASSERT_EQ(uut.halfmove, expected.halfmove);
+  ASSERT_EQ(uut.fullmove, expected.fullmove);
+}
+
+TEST(BoardFen, EnPassant) {
+  const pawntificate::board expected("e2e4 g8f6 e4e5 d7d5");
+
+  pawntificate::board uut;
+  ASSERT_TRUE(pawntificate::parse_fen("rnbqkb1r/ppp1pppp/5n2/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3", uut));
+  ASSERT_EQ(uut, expected);
+  ASSERT_EQ(uut.hash, expected.hash);
+}
+
+TEST(BoardFen, Epd) {
+  // no clocks, operations instead.
+  pawntificate::board uut;
+  ASSERT_TRUE(pawntificate::parse_fen("6k1/8/8/8/8/8/8/4K2R b K - c9 \"1-0\";", uut));
+  ASSERT_EQ(uut.active, colour::black);
+  ASSERT_EQ(uut.castling, castle::white_short);
+  ASSERT_EQ(uut.halfmove, 0u);
+  ASSERT_EQ(uut.fullmove, 1u);
+  ASSERT_EQ(uut.piece_board[static_cast<std::size_t>(square::h1)], R);
+}
+
+TEST(BoardFen, Malformed) {
+  for (const auto fen : {
+    "",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1",
+    "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNRR w KQkq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQ1BNR w kq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e5 0 1",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNX w KQkq - 0 1"
+  }) {
+    pawntificate::board uut("e2e4");
+    ASSERT_FALSE(pawntificate::parse_fen(fen, uut)) << fen;
+    ASSERT_EQ(uut, pawntificate::board("e2e4"));
+  }
+}
+
 // bugs from real games
 
 TEST(RealGame, InvalidCastling) {
@@ -244,3 +429,51 @@ TEST(RealGame, InvalidCastling) {
     _, _, _, _, _, _, k, _
   }, castle::_));
 }
+
+namespace {
+
+auto san(const std::string_view fen, const move m) -> std::string {
+  pawntificate::board b;
+  EXPECT_TRUE(pawntificate::parse_fen(fen, b));
+
+  std::ostringstream os;
+  pawntificate::to_san(os, b, m);
+  return os.str();
+}
+
+} // unnamed namespace
+
+TEST(BoardSan, PawnsAndPieces) {
+  const auto start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+  ASSERT_EQ(san(start, move{square::e2, square::e4}), "e4");
+  ASSERT_EQ(san(start, move{square::g1, square::f3}), "Nf3");
+
+  // a capture, and one en passant onto an empty square.
+  const auto open = "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3";
+  ASSERT_EQ(san(open, move{square::e5, square::f6}), "exf6");
+  ASSERT_EQ(san(open, move{square::d1, square::h5}), "Qh5+");
+}
+
+TEST(BoardSan, Disambiguation) {
+  // knights on b1 and f1 can both go to d2, rooks on a1 and a5 can both go to
+  // a3, and three queens can go to e1.
+  const auto fen = "7k/8/8/R7/8/8/8/RN3N1K w - - 0 1";
+  ASSERT_EQ(san(fen, move{square::b1, square::d2}), "Nbd2");
+  ASSERT_EQ(san(fen, move{square::a1, square::a3}), "R1a3");
+  ASSERT_EQ(san(fen, move{square::a5, square::a3}), "R5a3");
+
+  const auto queens = "1k6/8/8/8/4Q2Q/8/8/K6Q w - - 0 1";
+  ASSERT_EQ(san(queens, move{square::h4, square::e1}), "Qh4e1");
+  ASSERT_EQ(san(queens, move{square::e4, square::e1}), "Qee1");
+  ASSERT_EQ(san(queens, move{square::h1, square::e1}), "Q1e1");
+}
+
+TEST(BoardSan, CastlingPromotionAndMate) {
+  const auto castling = "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1";
+  ASSERT_EQ(san(castling, move{square::e1, square::g1}), "O-O");
+  ASSERT_EQ(san(castling, move{square::e1, square::c1}), "O-O-O");
+
+  ASSERT_EQ(san("8/4P3/8/8/8/8/8/k1K5 w - - 0 1", move{square::e7, square::e8, ptype::queen}), "e8=Q");
+  ASSERT_EQ(san("k7/4P3/8/8/8/8/8/2K5 w - - 0 1", move{square::e7, square::e8, ptype::rook}), "e8=R+");
+  ASSERT_EQ(san("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", move{square::a1, square::a8}), "Ra8#");
+}
@@ -0,0 +1,478 @@
+#include <gtest/gtest.h>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/engine.hpp>
+
+using pawntificate::move;
+using pawntificate::square;
+
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+namespace {
+
+// run a search with the given limits and wait for its result.
+auto search(pawntificate::engine &engine,
+            const pawntificate::board &b,
+            const pawntificate::search_limits &limits,
+            const pawntificate::key_history &game = {}) -> pawntificate::search_result {
+  std::mt19937 gen;
+  pawntificate::search_result result;
+  engine.start(b, game, limits, gen, [&](const pawntificate::search_result &r) {
+    result = r;
+  });
+
+  engine.wait();
+  return result;
+}
+
+} // unnamed namespace
+
+using parallel = std::pair<pawntificate::parallel_search, std::size_t>;
+class Threads : public TestWithParam<parallel> {};
+
+TEST_P(Threads, MateInOne) {
+  // scholar's mate: 1. e4 e5 2. Qf3 Nc6 3. Bc4 Bc5 4. Qxf7#
+  pawntificate::board uut("e2e4 e7e5 d1f3 b8c6 f1c4 f8c5");
+
+  pawntificate::engine engine;
+  engine.set_parallel_search(GetParam().first);
+  engine.set_threads(GetParam().second);
+
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 4, gen);
+  ASSERT_EQ(result.best, move(square::f3, square::f7, true));
+  ASSERT_EQ(result.value, pawntificate::mate - 1);
+  ASSERT_GT(result.nodes, 0u);
+}
+
+TEST_P(Threads, WinsHangingRook) {
+  // 1. a4 a6 2. b4 e6 3. b5 axb5 4. axb5 Rxa1
+  pawntificate::board uut("a2a4 a7a6 b2b4 e7e6 b4b5 a6b5 a4b5");
+
+  pawntificate::engine engine;
+  engine.set_parallel_search(GetParam().first);
+  engine.set_threads(GetParam().second);
+
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 6, gen);
+  ASSERT_EQ(result.best, move(square::a8, square::a1, true));
+}
+
+INSTANTIATE_TEST_SUITE_P(LazySmp, Threads, Values(
+  parallel{pawntificate::parallel_search::shared_hash, 1ul},
+  parallel{pawntificate::parallel_search::shared_hash, 2ul},
+  parallel{pawntificate::parallel_search::shared_hash, 4ul}
+));
+
+INSTANTIATE_TEST_SUITE_P(TreeSplit, Threads, Values(
+  parallel{pawntificate::parallel_search::tree_split, 1ul},
+  parallel{pawntificate::parallel_search::tree_split, 2ul},
+  parallel{pawntificate::parallel_search::tree_split, 4ul}
+));
+
+TEST(Engine, ReusesTranspositionTable) {
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6");
+
+  pawntificate::engine engine;
+  std::mt19937 gen1;
+  const auto first = engine.search(uut, 5, gen1);
+
+  // the second search starts with all of the work of the first in the table.
+  std::mt19937 gen2;
+  const auto second = engine.search(uut, 5, gen2);
+  ASSERT_LT(second.nodes, first.nodes);
+
+  // until it's cleared.
+  engine.new_game();
+  std::mt19937 gen3;
+  const auto third = engine.search(uut, 5, gen3);
+  ASSERT_EQ(third.nodes, first.nodes);
+}
+
+TEST(Engine, SharesTranspositionTable) {
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6");
+  pawntificate::transposition_table shared(16);
+
+  pawntificate::engine lhs(shared);
+  std::mt19937 gen1;
+  const auto first = lhs.search(uut, 5, gen1);
+
+  // another engine searching the same position finds the work of the first.
+  pawntificate::engine rhs(shared);
+  std::mt19937 gen2;
+  const auto second = rhs.search(uut, 5, gen2);
+  ASSERT_LT(second.nodes, first.nodes);
+
+  // but one with a table of its own doesn't.
+  pawntificate::engine own;
+  std::mt19937 gen3;
+  ASSERT_EQ(own.search(uut, 5, gen3).nodes, first.nodes);
+}
+
+TEST(MultiPV, SingleLine) {
+  pawntificate::board uut("e2e4 e7e5 d1f3 b8c6 f1c4 f8c5");
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 3, gen);
+  ASSERT_EQ(result.lines.size(), 1u);
+  ASSERT_EQ(result.lines[0].value, result.value);
+  ASSERT_EQ(result.lines[0].moves.front(), result.best);
+}
+
+TEST(MultiPV, BestLinesInOrder) {
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6 f1c4 g8f6");
+
+  pawntificate::engine engine;
+  engine.set_multi_pv(3);
+
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 4, gen);
+  ASSERT_EQ(result.lines.size(), 3u);
+  ASSERT_EQ(result.lines[0].moves.front(), result.best);
+  ASSERT_GE(result.lines[0].value, result.lines[1].value);
+  ASSERT_GE(result.lines[1].value, result.lines[2].value);
+  ASSERT_NE(result.lines[0].moves.front(), result.lines[1].moves.front());
+  ASSERT_NE(result.lines[1].moves.front(), result.lines[2].moves.front());
+
+  for (const auto &line : result.lines) {
+    ASSERT_FALSE(line.moves.empty());
+    ASSERT_LE(line.moves.size(), 4u);
+  }
+}
+
+TEST(MultiPV, MoreLinesThanMoves) {
+  // black is in check so only has a few legal moves.
+  pawntificate::board uut("e2e4 e7e5 f1c4 d7d6 c4f7");
+
+  pawntificate::engine engine;
+  engine.set_multi_pv(50);
+
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 2, gen);
+  ASSERT_EQ(result.lines.size(), pawntificate::find_legal_moves(uut).size());
+}
+
+TEST(Engine, StopIsResponsive) {
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6 f1c4 g8f6");
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+
+  std::atomic<bool> finished{false};
+  pawntificate::search_result result;
+  engine.start(uut, {}, pawntificate::search_limits{}, gen, [&](const pawntificate::search_result &r) {
+    result = r;
+    finished = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(finished);
+
+  const auto start = std::chrono::steady_clock::now();
+  engine.stop();
+  engine.wait();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // far less than the search would take on its own, with plenty of room for a
+  // loaded machine.
+  ASSERT_TRUE(finished);
+  ASSERT_LT(elapsed, std::chrono::seconds(2));
+
+  const auto moves = pawntificate::find_legal_moves(uut);
+  ASSERT_NE(std::find(std::begin(moves), std::end(moves), result.best), std::end(moves));
+}
+
+TEST(Engine, StopBeforeFirstIteration) {
+  pawntificate::board uut;
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+
+  pawntificate::search_result result;
+  engine.start(uut, {}, pawntificate::search_limits{}, gen, [&](const pawntificate::search_result &r) {
+    result = r;
+  });
+  engine.stop();
+  engine.wait();
+
+  // there is always a move to play.
+  const auto moves = pawntificate::find_legal_moves(uut);
+  ASSERT_NE(std::find(std::begin(moves), std::end(moves), result.best), std::end(moves));
+}
+
+TEST(Ponder, HoldsResultUntilPonderhit) {
+  pawntificate::board uut("e2e4 e7e5 g1f3");
+
+  pawntificate::search_limits limits;
+  limits.depth = 2;
+  limits.ponder = true;
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+
+  std::atomic<bool> finished{false};
+  engine.start(uut, {}, limits, gen, [&](const pawntificate::search_result &) {
+    finished = true;
+  });
+
+  // a depth 2 search is done almost immediately.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(finished);
+
+  engine.ponderhit();
+  engine.wait();
+  ASSERT_TRUE(finished);
+}
+
+TEST(Ponder, ClockStartsAtPonderhit) {
+  using namespace std::chrono_literals;
+
+  pawntificate::board uut("e2e4 e7e5 g1f3");
+
+  // roughly a 30ms budget, which is ignored while pondering.
+  pawntificate::search_limits limits;
+  limits.wtime = 1000ms;
+  limits.btime = 1000ms;
+  limits.ponder = true;
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+
+  std::atomic<bool> finished{false};
+  pawntificate::search_result result;
+  engine.start(uut, {}, limits, gen, [&](const pawntificate::search_result &r) {
+    result = r;
+    finished = true;
+  });
+
+  std::this_thread::sleep_for(100ms);
+  ASSERT_FALSE(finished);
+
+  // the work done while pondering carries on into the timed search.
+  const auto start = std::chrono::steady_clock::now();
+  engine.ponderhit();
+  engine.wait();
+  ASSERT_TRUE(finished);
+  ASSERT_LT(std::chrono::steady_clock::now() - start, 5s);
+  ASSERT_GE(result.time, 100ms);
+  ASSERT_GT(result.depth, 0u);
+}
+
+TEST(Ponder, StopWhilePondering) {
+  pawntificate::board uut("e2e4 e7e5 g1f3");
+
+  pawntificate::search_limits limits;
+  limits.depth = 2;
+  limits.ponder = true;
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+
+  std::atomic<bool> finished{false};
+  engine.start(uut, {}, limits, gen, [&](const pawntificate::search_result &) {
+    finished = true;
+  });
+
+  engine.stop();
+  engine.wait();
+  ASSERT_TRUE(finished);
+}
+
+TEST(TimeManagement, RespectsClock) {
+  using namespace std::chrono_literals;
+
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6 f1c4 g8f6");
+
+  pawntificate::search_limits limits;
+  limits.wtime = 3000ms;
+  limits.btime = 3000ms;
+
+  pawntificate::engine engine;
+  const auto result = search(engine, uut, limits);
+
+  // the budget is around 100ms, the bound leaves room for a loaded machine.
+  ASSERT_LT(result.time, 1500ms);
+  ASSERT_GT(result.depth, 0u);
+}
+
+TEST(Limits, Nodes) {
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6 f1c4 g8f6");
+
+  for (const auto threads : {1ul, 2ul}) {
+    pawntificate::search_limits limits;
+    limits.nodes = 5000;
+
+    pawntificate::engine engine;
+    engine.set_threads(threads);
+    const auto result = search(engine, uut, limits);
+
+    // each thread stops on its share of the nodes, the others within a poll.
+    ASSERT_LE(result.nodes, 5000u + 1024u * (threads - 1));
+    ASSERT_GE(result.nodes, 5000u / threads);
+    ASSERT_GT(result.depth, 0u);
+  }
+}
+
+TEST(Limits, MoveTime) {
+  using namespace std::chrono_literals;
+
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6 f1c4 g8f6");
+
+  pawntificate::search_limits limits;
+  limits.movetime = 200ms;
+
+  pawntificate::engine engine;
+  const auto start = std::chrono::steady_clock::now();
+  search(engine, uut, limits);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // the whole of the time is used, rather than stopping once an iteration
+  // looks like it won't finish. the clock starts as the search is started, so
+  // it is timed from out here. the upper bound leaves room for a loaded
+  // machine.
+  ASSERT_GE(elapsed, 200ms);
+  ASSERT_LT(elapsed, 2000ms);
+}
+
+TEST(Limits, Infinite) {
+  pawntificate::board uut("e2e4 e7e5 g1f3");
+
+  // the depth runs out straight away, but the result is held until stop.
+  pawntificate::search_limits limits;
+  limits.depth = 2;
+  limits.infinite = true;
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+
+  std::atomic<bool> finished{false};
+  engine.start(uut, {}, limits, gen, [&](const pawntificate::search_result &) {
+    finished = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(finished);
+
+  engine.ponderhit();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(finished);
+
+  engine.stop();
+  engine.wait();
+  ASSERT_TRUE(finished);
+}
+
+TEST(Limits, SearchMoves) {
+  // taking the hanging rook is best, but only the pawn moves are allowed.
+  pawntificate::board uut("a2a4 a7a6 b2b4 e7e6 b4b5 a6b5 a4b5");
+
+  pawntificate::search_limits limits;
+  limits.depth = 4;
+  limits.searchmoves.emplace_back(square::h7, square::h6);
+  limits.searchmoves.emplace_back(square::g7, square::g5);
+
+  pawntificate::engine engine;
+  const auto result = search(engine, uut, limits);
+
+  ASSERT_TRUE(result.best == move(square::h7, square::h6) || result.best == move(square::g7, square::g5));
+}
+
+TEST(Limits, Mate) {
+  // scholar's mate is a mate in one, which is found without going any deeper.
+  pawntificate::board uut("e2e4 e7e5 d1f3 b8c6 f1c4 f8c5");
+
+  pawntificate::search_limits limits;
+  limits.mate = 1;
+
+  pawntificate::engine engine;
+  const auto result = search(engine, uut, limits);
+
+  ASSERT_EQ(result.best, move(square::f3, square::f7, true));
+  ASSERT_EQ(result.value, pawntificate::mate - 1);
+  ASSERT_LE(result.depth, 3u);
+}
+
+TEST(Engine, ReportsProgress) {
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6");
+  pawntificate::engine engine;
+  engine.set_multi_pv(2);
+
+  std::vector<std::size_t> iterations;
+  std::size_t currmoves = 0;
+  std::uint64_t nodes = 0;
+  engine.set_info_handler([&](const pawntificate::search_info &info) {
+    if (info.lines.empty()) {
+      ASSERT_GT(info.currmovenumber, 0u);
+      ++currmoves;
+    } else {
+      ASSERT_EQ(info.lines.size(), 2u);
+      ASSERT_GE(info.seldepth, info.depth);
+      ASSERT_GE(info.nodes, nodes);
+      iterations.push_back(info.depth);
+      nodes = info.nodes;
+    }
+  });
+
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 4, gen);
+
+  // every iteration is reported along with each of its root moves.
+  ASSERT_EQ(iterations, (std::vector<std::size_t>{1, 2, 3, 4}));
+  ASSERT_GT(currmoves, 4u);
+  ASSERT_LE(nodes, result.nodes);
+}
+
+TEST(Draws, RepetitionSavesLostPosition) {
+  // black has given away their queen but can repeat the position by moving
+  // their knight back out, which is much better than playing on.
+  const auto moves = "e2e4 d7d5 e4d5 d8d5 b1c3 d5d2 c1d2 g8f6 g1f3 f6g8 f3g1";
+
+  pawntificate::board uut;
+  pawntificate::key_history game;
+  uut.play(moves, [&](const pawntificate::board &b) {
+    game.push(b.hash);
+  });
+
+  pawntificate::search_limits limits;
+  limits.depth = 3;
+
+  pawntificate::engine engine;
+  const auto result = search(engine, uut, limits, game);
+
+  ASSERT_EQ(result.best, move(square::g8, square::f6));
+  ASSERT_EQ(result.value, 0);
+
+  // without the history the knight move looks like any other.
+  engine.new_game();
+  const auto no_history = search(engine, uut, limits);
+  ASSERT_LT(no_history.value, 0);
+}
+
+TEST(Mate, StopsOnceFound) {
+  // fool's mate: 1. f3 e5 2. g4 Qh4#
+  pawntificate::board uut("f2f3 e7e5 g2g4");
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 4, gen);
+  ASSERT_EQ(result.best, move(square::d8, square::h4));
+  ASSERT_EQ(result.value, pawntificate::mate - 1);
+
+  // no longer lines are searched once the mate has been found.
+  ASSERT_LT(result.depth, 4u);
+}
+
+TEST(Draws, AvoidsStalemate) {
+  // one move away from sam loyd's ten move stalemate, 10. Qe6 would stalemate
+  // black when white is a queen and more ahead.
+  pawntificate::board uut("e2e3 a7a5 d1h5 a8a6 h5a5 h7h5 h2h4 a6h6 a5c7 f7f6 "
+                          "c7d7 e8f7 d7b7 d8d3 b7b8 d3h7 b8c8 f7g6");
+
+  pawntificate::engine engine;
+  std::mt19937 gen;
+  const auto result = engine.search(uut, 3, gen);
+  ASSERT_NE(result.best, move(square::c8, square::e6));
+  ASSERT_GT(result.value, 0);
+}
@@ -0,0 +1,83 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/engine.hpp>
+#include <pawntificate/eval_cache.hpp>
+
+using pawntificate::eval_cache;
+using pawntificate::score;
+
+namespace {
+
+constexpr std::uint64_t key = 0x9e3779b97f4a7c15ull;
+
+} // unnamed namespace
+
+TEST(EvalCache, EmptyCacheMisses) {
+  eval_cache uut(1);
+
+  score result = 0;
+  ASSERT_FALSE(uut.probe(key, result));
+  ASSERT_FALSE(uut.probe(0u, result));
+}
+
+TEST(EvalCache, StoreAndProbe) {
+  eval_cache uut(1);
+  uut.store(key, -300);
+  uut.store(key + 1, 42);
+
+  score result = 0;
+  ASSERT_TRUE(uut.probe(key, result));
+  ASSERT_EQ(result, -300);
+  ASSERT_TRUE(uut.probe(key + 1, result));
+  ASSERT_EQ(result, 42);
+}
+
+TEST(EvalCache, DifferentKeySameSlot) {
+  eval_cache uut(1);
+  uut.store(key, 1);
+
+  // the index only uses the low bits of the key.
+  score result = 0;
+  ASSERT_FALSE(uut.probe(key ^ (1ull << 63u), result));
+}
+
+TEST(EvalCache, Clear) {
+  eval_cache uut(1);
+  uut.store(key, 1);
+  uut.clear();
+
+  score result = 0;
+  ASSERT_FALSE(uut.probe(key, result));
+}
+
+TEST(EvalCache, SearchHits) {
+  pawntificate::engine uut;
+  std::mt19937 gen;
+
+  // the same leaves are reached by different move orders, and the second
+  // search finds most of the first's.
+  const auto first = uut.search(pawntificate::board{}, 5, gen);
+  ASSERT_GT(first.eval_hits, 0u);
+  ASSERT_GT(first.eval_misses, 0u);
+
+  const auto second = uut.search(pawntificate::board{}, 5, gen);
+  ASSERT_GT(second.eval_hits, second.eval_misses);
+}
+
+TEST(EvalCache, NewGameForgets) {
+  pawntificate::engine uut;
+
+  // once the engine has forgotten the last game, the same search finds nothing
+  // cached and goes exactly as it did the first time.
+  std::mt19937 gen1;
+  const auto first = uut.search(pawntificate::board{}, 4, gen1);
+  uut.new_game();
+
+  std::mt19937 gen2;
+  const auto second = uut.search(pawntificate::board{}, 4, gen2);
+  ASSERT_EQ(second.eval_misses, first.eval_misses);
+  ASSERT_EQ(second.eval_hits, first.eval_hits);
+}
@@ -1,7 +1,12 @@
+#include <filesystem>
+#include <fstream>
+
 #include <gtest/gtest.h>
 
 #include <pawntificate/board.hpp>
 #include <pawntificate/evaluate.hpp>
+#include <pawntificate/pawns.hpp>
+#include <pawntificate/psqt.hpp>
 
 using namespace std::literals;
 
@@ -38,6 +43,85 @@ constexpr std::size_t max_depth = pawntificate::default_depth;
 
 INSTANTIATE_TEST_SUITE_P(Depth, Evaluate, Range(1ul, max_depth));
 
+TEST(EvaluatePosition, StartIsLevel) {
+  ASSERT_EQ(pawntificate::evaluate_position(pawntificate::board{}), 0);
+}
+
+TEST(EvaluatePosition, SideToMove) {
+  // white has won a pawn, though it has doubled them, it's black to move.
+  pawntificate::board uut("e2e4 d7d5 e4d5");
+  ASSERT_LT(pawntificate::evaluate_position(uut), -25);
+  ASSERT_GT(pawntificate::evaluate_position(pawntificate::board{uut, move{square::g8, square::f6}}), 25);
+}
+
+TEST(EvaluatePosition, PawnTableMatchesScratch) {
+  pawntificate::pawn_table pawns;
+  for (const auto moves : {"e2e4 d7d5 e4d5", "e2e4 d7d5 e4d5 g8f6", "a2a4 h7h5 a4a5 b7b5 a5b6"}) {
+    const pawntificate::board b(moves);
+    ASSERT_EQ(pawntificate::evaluate_position(b, pawns), pawntificate::evaluate_position(b));
+  }
+}
+
+TEST(EvaluatePosition, CentralisedKnight) {
+  ASSERT_GT(pawntificate::evaluate_position(pawntificate::board("b1c3 b8a6")), 0);
+}
+
+TEST(EvaluationParameters, RoundTrip) {
+  const auto path = std::filesystem::temp_directory_path() / "pawntificate-test.params";
+  auto params = pawntificate::psqt::defaults;
+  params.mg_value[2] = 300;
+  params.eg_raw[6][63] = -7;
+  ASSERT_TRUE(pawntificate::psqt::save_parameters(path, params));
+
+  auto uut = pawntificate::psqt::defaults;
+  ASSERT_TRUE(pawntificate::psqt::load_parameters(path, uut));
+  ASSERT_EQ(uut.mg_value, params.mg_value);
+  ASSERT_EQ(uut.eg_value, params.eg_value);
+  ASSERT_EQ(uut.mg_raw, params.mg_raw);
+  ASSERT_EQ(uut.eg_raw, params.eg_raw);
+  std::filesystem::remove(path);
+}
+
+TEST(EvaluationParameters, RejectsMalformed) {
+  const auto path = std::filesystem::temp_directory_path() / "pawntificate-test.params";
+  for (const auto contents : {"", "mg_value 0 82 337 365 477 1025 0\n", "mg_value 0 82 337\n"}) {
+    std::ofstream{path} << contents;
+
+    auto uut = pawntificate::psqt::defaults;
+    uut.mg_value[1] = 1;
+    ASSERT_FALSE(pawntificate::psqt::load_parameters(path, uut));
+    ASSERT_EQ(uut.mg_value[1], 1);
+  }
+
+  std::filesystem::remove(path);
+  auto uut = pawntificate::psqt::defaults;
+  ASSERT_FALSE(pawntificate::psqt::load_parameters(path, uut));
+}
+
+TEST(EvaluationParameters, OwnWeights) {
+  // a knight up in a bare endgame.
+  pawntificate::board b;
+  ASSERT_TRUE(pawntificate::parse_fen("4k3/8/8/8/8/8/8/1N2K3 w - - 0 1", b));
+  const auto before = pawntificate::evaluate_position(b);
+
+  auto params = pawntificate::psqt::defaults;
+  params.mg_value[2] += 100;
+  params.eg_value[2] += 100;
+  const auto weights = pawntificate::psqt::make_weights(params);
+
+  // the other boards keep the default weights.
+  auto uut = b;
+  uut.psq = uut.compute_psq(weights);
+  ASSERT_EQ(pawntificate::evaluate_position(uut), before + 100);
+  ASSERT_EQ(pawntificate::evaluate_position(b), before);
+
+  // and a move made from it keeps its weights.
+  uut.make_move(pawntificate::move{pawntificate::square::e1, pawntificate::square::e2});
+  b.make_move(pawntificate::move{pawntificate::square::e1, pawntificate::square::e2});
+  ASSERT_EQ(uut.psq, uut.compute_psq(weights));
+  ASSERT_EQ(pawntificate::evaluate_position(uut), pawntificate::evaluate_position(b) - 100);
+}
+
 // bugs from real games
 
 TEST(RealGame, OnlyLegalMove) {
@@ -721,3 +721,22 @@ TEST(RealGame, EnemyKingProtectsEscapeSquare2) {
     move(square::e4, square::f4)
   }));
 }
+
+TEST(InCheck, StartingPosition) {
+  ASSERT_FALSE(pawntificate::in_check(pawntificate::board{}));
+}
+
+TEST(InCheck, Checkmate) {
+  // fool's mate: 1. f3 e5 2. g4 Qh4#
+  pawntificate::board uut("f2f3 e7e5 g2g4 d8h4");
+  ASSERT_TRUE(pawntificate::in_check(uut));
+  ASSERT_TRUE(pawntificate::find_legal_moves(uut).empty());
+}
+
+TEST(InCheck, Stalemate) {
+  // sam loyd's ten move stalemate.
+  pawntificate::board uut("e2e3 a7a5 d1h5 a8a6 h5a5 h7h5 h2h4 a6h6 a5c7 f7f6 "
+                          "c7d7 e8f7 d7b7 d8d3 b7b8 d3h7 b8c8 f7g6 c8e6");
+  ASSERT_FALSE(pawntificate::in_check(uut));
+  ASSERT_TRUE(pawntificate::find_legal_moves(uut).empty());
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <pawntificate/key_history.hpp>
+
+using pawntificate::key_history;
+
+TEST(KeyHistory, Empty) {
+  key_history uut;
+  ASSERT_EQ(uut.size(), 0u);
+  ASSERT_FALSE(uut.is_repetition(1u, 100));
+}
+
+TEST(KeyHistory, Repetition) {
+  // a b c d a: the key 1 occurred four plies ago.
+  key_history uut;
+  uut.push(1u);
+  uut.push(2u);
+  uut.push(3u);
+  uut.push(4u);
+
+  ASSERT_TRUE(uut.is_repetition(1u, 4));
+  ASSERT_FALSE(uut.is_repetition(2u, 4));
+  ASSERT_FALSE(uut.is_repetition(3u, 4));
+  ASSERT_FALSE(uut.is_repetition(4u, 4));
+}
+
+TEST(KeyHistory, OnlySinceIrreversibleMove) {
+  key_history uut;
+  uut.push(1u);
+  uut.push(2u);
+  uut.push(3u);
+  uut.push(4u);
+
+  // a capture or pawn move three plies ago means the position can't repeat.
+  ASSERT_FALSE(uut.is_repetition(1u, 3));
+}
+
+TEST(KeyHistory, PushAndPop) {
+  key_history uut;
+  uut.push(1u);
+  uut.push(2u);
+  uut.push(3u);
+  uut.push(4u);
+  uut.push(5u);
+  uut.pop();
+
+  ASSERT_EQ(uut.size(), 4u);
+  ASSERT_EQ(uut.back(), 4u);
+  ASSERT_TRUE(uut.is_repetition(1u, 10));
+}
+
+TEST(KeyHistory, DropsOldestWhenFull) {
+  key_history uut;
+  for (auto i = 0ul; i < key_history::capacity; ++i) {
+    uut.push(i);
+  }
+
+  uut.push(key_history::capacity);
+  ASSERT_EQ(uut.size(), key_history::capacity / 2 + 1);
+  ASSERT_EQ(uut.back(), key_history::capacity);
+  ASSERT_TRUE(uut.is_repetition(key_history::capacity - 3, 100));
+  ASSERT_FALSE(uut.is_repetition(0u, 1000));
+}
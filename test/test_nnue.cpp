@@ -0,0 +1,163 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/engine.hpp>
+#include <pawntificate/nnue.hpp>
+
+namespace nnue = pawntificate::nnue;
+
+namespace {
+
+template <typename T>
+auto write(std::ofstream &out, const T value) -> void {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// writes count random weights of type T in [-limit, limit].
+template <typename T>
+auto write_random(std::ofstream &out, std::mt19937 &gen, const std::size_t count, const int limit) -> void {
+  std::uniform_int_distribution<int> dist{-limit, limit};
+  for (auto i = 0ul; i < count; ++i) {
+    write(out, static_cast<T>(dist(gen)));
+  }
+}
+
+// a network of random weights, small enough that nothing overflows.
+auto write_network(const std::filesystem::path &path) -> void {
+  std::mt19937 gen{42};
+  std::ofstream out{path, std::ios::binary};
+
+  out.write(nnue::magic.data(), nnue::magic.size());
+  write(out, nnue::version);
+  write(out, static_cast<std::uint32_t>(nnue::half_dimensions));
+  write(out, static_cast<std::uint32_t>(nnue::hidden_dimensions));
+  for (auto i = nnue::magic.size() + 12; i < nnue::header_size; ++i) {
+    write(out, '\0');
+  }
+
+  write_random<std::int16_t>(out, gen, nnue::half_dimensions, 32);
+  write_random<std::int16_t>(out, gen, nnue::feature_count * nnue::half_dimensions, 8);
+  write_random<std::int32_t>(out, gen, nnue::hidden_dimensions, 256);
+  write_random<std::int8_t>(out, gen, nnue::hidden_dimensions * 2 * nnue::half_dimensions, 16);
+  write_random<std::int32_t>(out, gen, nnue::hidden_dimensions, 256);
+  write_random<std::int8_t>(out, gen, nnue::hidden_dimensions * nnue::hidden_dimensions, 16);
+  write_random<std::int32_t>(out, gen, 1, 256);
+  write_random<std::int8_t>(out, gen, nnue::hidden_dimensions, 16);
+}
+
+auto network_path() -> std::filesystem::path {
+  return std::filesystem::temp_directory_path() / "pawntificate_test_nnue.bin";
+}
+
+} // unnamed namespace
+
+class Network : public ::testing::Test {
+protected:
+  static auto SetUpTestSuite() -> void {
+    write_network(network_path());
+  }
+
+  static auto TearDownTestSuite() -> void {
+    std::filesystem::remove(network_path());
+  }
+};
+
+TEST_F(Network, Loads) {
+  ASSERT_EQ(std::filesystem::file_size(network_path()), nnue::file_size);
+
+  nnue::network uut;
+  ASSERT_FALSE(uut.loaded());
+  ASSERT_TRUE(uut.load(network_path()));
+  ASSERT_TRUE(uut.loaded());
+}
+
+TEST_F(Network, RejectsOtherFiles) {
+  nnue::network uut;
+  ASSERT_FALSE(uut.load(network_path().string() + ".missing"));
+
+  // the right size but the wrong magic.
+  const auto path = network_path().string() + ".bad";
+  std::filesystem::copy_file(network_path(), path, std::filesystem::copy_options::overwrite_existing);
+  {
+    std::fstream out{path, std::ios::binary | std::ios::in | std::ios::out};
+    out.write("nope", 4);
+  }
+
+  ASSERT_FALSE(uut.load(path));
+  ASSERT_FALSE(uut.loaded());
+  std::filesystem::remove(path);
+}
+
+TEST_F(Network, IncrementalMatchesRefresh) {
+  nnue::network uut;
+  ASSERT_TRUE(uut.load(network_path()));
+
+  // a random game, which covers captures, castling, promotions and king moves
+  // along the way.
+  std::mt19937 gen{7};
+  pawntificate::board b;
+  nnue::accumulator acc;
+  uut.refresh(b, acc);
+
+  for (auto ply = 0; ply < 300; ++ply) {
+    const auto moves = pawntificate::find_legal_moves(b);
+    if (moves.empty() || b.halfmove >= 100) {
+      break;
+    }
+
+    const auto m = moves[std::uniform_int_distribution<std::size_t>{0, moves.size() - 1}(gen)];
+    const pawntificate::board next{b, m};
+
+    nnue::accumulator incremental;
+    uut.update(b, acc, next, incremental);
+
+    nnue::accumulator scratch;
+    uut.refresh(next, scratch);
+    ASSERT_EQ(incremental.values, scratch.values) << "ply " << ply;
+    ASSERT_EQ(uut.evaluate(next, incremental), uut.evaluate(next, scratch));
+
+    b = next;
+    acc = incremental;
+  }
+}
+
+TEST_F(Network, SideToMove) {
+  nnue::network uut;
+  ASSERT_TRUE(uut.load(network_path()));
+
+  // the same position seen from either side, mirrored and with the colours
+  // swapped, is the same to the side to move.
+  const pawntificate::board white("e2e4 e7e5 g1f3");
+  auto mirrored = white.piece_board;
+  for (auto s = 0ul; s < mirrored.size(); ++s) {
+    const auto p = white.piece_board[s ^ 56u];
+    mirrored[s] = p == pawntificate::pieces::_ ? p : pawntificate::piece(p.opcode ^ 1u);
+  }
+
+  const pawntificate::board black(pawntificate::colour::white, mirrored, white.castling, white.en_passant);
+
+  nnue::accumulator lhs;
+  nnue::accumulator rhs;
+  uut.refresh(white, lhs);
+  uut.refresh(black, rhs);
+  ASSERT_EQ(uut.evaluate(white, lhs), uut.evaluate(black, rhs));
+}
+
+TEST_F(Network, Search) {
+  pawntificate::engine uut;
+  uut.set_evaluator(pawntificate::evaluator::nnue);
+  ASSERT_TRUE(uut.load_network(network_path()));
+
+  std::mt19937 gen{0};
+  const pawntificate::board b;
+  const auto result = uut.search(b, 4, gen);
+
+  const auto moves = pawntificate::find_legal_moves(b);
+  ASSERT_NE(std::find(std::begin(moves), std::end(moves), result.best), std::end(moves));
+  ASSERT_EQ(result.depth, 4ul);
+}
@@ -0,0 +1,145 @@
+#include <initializer_list>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/pawns.hpp>
+
+using namespace pawntificate::pieces;
+
+using pawntificate::castle;
+using pawntificate::colour;
+using pawntificate::square;
+
+namespace {
+
+// a board with just the kings and the given pieces, white to move.
+auto make_board(const std::initializer_list<std::pair<square, pawntificate::piece>> pieces)
+    -> pawntificate::board {
+  std::array<pawntificate::piece, 64> squares{};
+  squares[static_cast<std::size_t>(square::e1)] = K;
+  squares[static_cast<std::size_t>(square::e8)] = k;
+  for (const auto &[s, p] : pieces) {
+    squares[static_cast<std::size_t>(s)] = p;
+  }
+
+  return {colour::white, squares, castle::_};
+}
+
+constexpr auto bit(const square s) -> std::uint64_t {
+  return 1ull << static_cast<unsigned>(s);
+}
+
+} // unnamed namespace
+
+TEST(EvaluatePawns, StartIsLevel) {
+  const auto uut = pawntificate::evaluate_pawns(pawntificate::board{});
+  ASSERT_EQ(uut.mg, 0);
+  ASSERT_EQ(uut.eg, 0);
+  ASSERT_EQ(uut.passed[0], 0u);
+  ASSERT_EQ(uut.passed[1], 0u);
+}
+
+TEST(EvaluatePawns, Passed) {
+  // e5 and d6 stop each other from being passed, a4 and h7 have nothing in
+  // front of them.
+  const auto uut = pawntificate::evaluate_pawns(make_board({
+    {square::e5, P}, {square::d6, p}, {square::a4, P}, {square::h7, p}
+  }));
+
+  ASSERT_EQ(uut.passed[static_cast<std::size_t>(colour::white)], bit(square::a4));
+  ASSERT_EQ(uut.passed[static_cast<std::size_t>(colour::black)], bit(square::h7));
+}
+
+TEST(EvaluatePawns, FurtherAdvancedPassedPawnIsBetter) {
+  const auto lhs = pawntificate::evaluate_pawns(make_board({{square::a6, P}}));
+  const auto rhs = pawntificate::evaluate_pawns(make_board({{square::a3, P}}));
+  ASSERT_GT(lhs.mg, rhs.mg);
+  ASSERT_GT(lhs.eg, rhs.eg);
+}
+
+TEST(EvaluatePawns, Isolated) {
+  // the same blocked pawns, with and without a neighbour.
+  const auto isolated = pawntificate::evaluate_pawns(make_board({
+    {square::c4, P}, {square::c5, p}, {square::h2, P}, {square::h7, p}
+  }));
+
+  const auto supported = pawntificate::evaluate_pawns(make_board({
+    {square::c4, P}, {square::c5, p}, {square::h2, P}, {square::h7, p}, {square::b2, P}
+  }));
+
+  ASSERT_LT(isolated.mg, supported.mg);
+}
+
+TEST(EvaluatePawns, Doubled) {
+  const auto doubled = pawntificate::evaluate_pawns(make_board({
+    {square::c2, P}, {square::c3, P}, {square::c7, p}, {square::d7, p}
+  }));
+
+  const auto level = pawntificate::evaluate_pawns(make_board({
+    {square::c2, P}, {square::d3, P}, {square::c7, p}, {square::d7, p}
+  }));
+
+  ASSERT_EQ(level.mg, 0);
+  ASSERT_LT(doubled.mg, 0);
+  ASSERT_LT(doubled.eg, 0);
+}
+
+TEST(EvaluatePawns, Backward) {
+  // nothing can come up to support d3 now that c4 has gone past it, and the
+  // black pawn on e5 controls d4.
+  const auto backward = pawntificate::evaluate_pawns(make_board({
+    {square::c4, P}, {square::d3, P}, {square::d5, p}, {square::e5, p}
+  }));
+
+  // the same but e2 can still support it.
+  const auto supported = pawntificate::evaluate_pawns(make_board({
+    {square::c4, P}, {square::d3, P}, {square::e2, P}, {square::d5, p}, {square::e5, p}
+  }));
+
+  ASSERT_LT(backward.mg, supported.mg);
+  ASSERT_LT(backward.eg, supported.eg);
+}
+
+TEST(EvaluatePawns, Symmetric) {
+  const pawntificate::board b("e2e4 d7d5 e4d5 c7c6 d5c6 b7c6 a2a4 h7h5 a4a5 h5h4");
+  const auto uut = pawntificate::evaluate_pawns(b);
+
+  // the same pawns with the colours swapped and the board mirrored.
+  auto mirrored = b.piece_board;
+  for (auto s = 0ul; s < mirrored.size(); ++s) {
+    const auto p = b.piece_board[s ^ 56u];
+    mirrored[s] = p == _ ? p : pawntificate::piece(p.opcode ^ 1u);
+  }
+
+  const auto flipped = pawntificate::evaluate_pawns(pawntificate::board(colour::black, mirrored));
+  ASSERT_EQ(uut.mg, -flipped.mg);
+  ASSERT_EQ(uut.eg, -flipped.eg);
+}
+
+TEST(PawnTable, CachesEntries) {
+  pawntificate::pawn_table uut(16);
+  const pawntificate::board b("e2e4 d7d5 e4d5");
+
+  const auto expected = pawntificate::evaluate_pawns(b);
+  const auto first = uut.probe(b);
+  ASSERT_EQ(uut.hits(), 0u);
+  ASSERT_EQ(uut.misses(), 1u);
+
+  // moving a piece doesn't change the pawn structure.
+  const auto second = uut.probe(pawntificate::board("e2e4 d7d5 e4d5 g8f6"));
+  ASSERT_EQ(uut.hits(), 1u);
+  ASSERT_EQ(uut.misses(), 1u);
+
+  for (const auto &e : {first, second}) {
+    ASSERT_EQ(e.key, expected.key);
+    ASSERT_EQ(e.mg, expected.mg);
+    ASSERT_EQ(e.eg, expected.eg);
+    ASSERT_EQ(e.passed, expected.passed);
+  }
+
+  uut.clear();
+  ASSERT_EQ(uut.hits(), 0u);
+  ASSERT_EQ(uut.misses(), 0u);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/evaluate.hpp>
+#include <pawntificate/pawns.hpp>
+#include <pawntificate/quiesce.hpp>
+
+using namespace pawntificate::pieces;
+
+using pawntificate::square;
+
+namespace {
+
+auto from_fen(const std::string_view fen) -> pawntificate::board {
+  pawntificate::board b;
+  EXPECT_TRUE(pawntificate::parse_fen(fen, b));
+  return b;
+}
+
+} // unnamed namespace
+
+TEST(Quiesce, QuietPosition) {
+  pawntificate::pawn_table pawns;
+  const pawntificate::board b;
+  const auto uut = pawntificate::quiesce(b, pawns);
+  ASSERT_EQ(uut.value, pawntificate::evaluate_position(b));
+  ASSERT_EQ(uut.leaf, b);
+}
+
+TEST(Quiesce, TakesHangingPiece) {
+  pawntificate::pawn_table pawns;
+  const auto b = from_fen("4k3/8/8/3q4/4P3/8/8/4K3 w - - 0 1");
+  const auto uut = pawntificate::quiesce(b, pawns);
+  ASSERT_GT(uut.value, 0);
+  ASSERT_GT(uut.value, pawntificate::evaluate_position(b) + 500);
+
+  // the pawn has taken the queen and it is black to move.
+  ASSERT_EQ(uut.leaf.piece_board[static_cast<std::size_t>(square::d5)], P);
+  ASSERT_EQ(uut.value, -pawntificate::evaluate_position(uut.leaf));
+}
+
+TEST(Quiesce, DeclinesLosingCapture) {
+  // the pawn on d5 is defended, taking it loses the queen.
+  pawntificate::pawn_table pawns;
+  const auto b = from_fen("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1");
+  const auto uut = pawntificate::quiesce(b, pawns);
+  ASSERT_EQ(uut.value, pawntificate::evaluate_position(b));
+  ASSERT_EQ(uut.leaf, b);
+}
+
+TEST(Quiesce, Mated) {
+  pawntificate::pawn_table pawns;
+  const pawntificate::board b("f2f3 e7e5 g2g4 d8h4");
+  const auto uut = pawntificate::quiesce(b, pawns);
+  ASSERT_EQ(uut.value, -pawntificate::mate);
+  ASSERT_TRUE(pawntificate::is_mate(uut.value));
+}
@@ -0,0 +1,84 @@
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/engine.hpp>
+
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+namespace {
+
+// every allocation made by the process, from any thread.
+std::atomic<std::size_t> allocations{0};
+
+} // unnamed namespace
+
+auto operator new(const std::size_t size) -> void * {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (const auto p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+
+  throw std::bad_alloc{};
+}
+
+auto operator delete(void *p) noexcept -> void {
+  std::free(p);
+}
+
+auto operator delete(void *p, std::size_t) noexcept -> void {
+  std::free(p);
+}
+
+using parallel = std::pair<pawntificate::parallel_search, std::size_t>;
+class SearchAllocations : public TestWithParam<parallel> {};
+
+TEST_P(SearchAllocations, NoneAfterNewGame) {
+  pawntificate::engine engine;
+  engine.set_parallel_search(GetParam().first);
+  engine.set_threads(GetParam().second);
+  engine.set_multi_pv(2);
+  engine.new_game();
+
+  pawntificate::board uut("e2e4 e7e5 g1f3 b8c6 f1c4");
+  pawntificate::key_history game;
+  pawntificate::search_limits limits;
+  limits.depth = 5;
+  std::mt19937 gen;
+
+  // counted from inside the search thread, before anything is done with the
+  // result. the callback only captures one reference so that it is small
+  // enough to not allocate itself.
+  struct {
+    std::size_t before = 0;
+    std::size_t during = 0;
+    std::uint64_t nodes = 0;
+  } counts;
+
+  std::function<void(const pawntificate::search_result &)> on_finish =
+    [&counts](const pawntificate::search_result &r) {
+      counts.during = allocations.load() - counts.before;
+      counts.nodes = r.nodes;
+    };
+
+  for (auto i = 0; i < 2; ++i) {
+    counts.before = allocations.load();
+    engine.start(uut, game, limits, gen, on_finish);
+    engine.wait();
+
+    ASSERT_EQ(counts.during, 0u);
+    ASSERT_GT(counts.nodes, 0u);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Engine, SearchAllocations, Values(
+  parallel{pawntificate::parallel_search::shared_hash, 1ul},
+  parallel{pawntificate::parallel_search::shared_hash, 4ul},
+  parallel{pawntificate::parallel_search::tree_split, 4ul}
+));
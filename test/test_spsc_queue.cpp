@@ -0,0 +1,70 @@
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <cxx/spsc_queue.hpp>
+
+TEST(SpscQueue, FirstInFirstOut) {
+  cxx::spsc_queue<int, 4> uut;
+
+  int value = 0;
+  ASSERT_FALSE(uut.try_pop(value));
+
+  for (auto i = 1; i <= 4; ++i) {
+    value = i;
+    ASSERT_TRUE(uut.try_push(value));
+  }
+
+  value = 5;
+  ASSERT_FALSE(uut.try_push(value));
+
+  for (auto i = 1; i <= 4; ++i) {
+    ASSERT_TRUE(uut.try_pop(value));
+    ASSERT_EQ(value, i);
+  }
+
+  ASSERT_FALSE(uut.try_pop(value));
+}
+
+TEST(SpscQueue, SwapsBuffers) {
+  cxx::spsc_queue<std::string, 2> uut;
+
+  // the string pushed is swapped with the empty one in its slot.
+  std::string line = "position startpos moves e2e4";
+  uut.push(line);
+  ASSERT_TRUE(line.empty());
+
+  std::string out = "go";
+  uut.pop(out);
+  ASSERT_EQ(out, "position startpos moves e2e4");
+
+  // the popped slot now holds the string we gave it, the next push into it
+  // hands it back.
+  uut.push(line);
+  ASSERT_TRUE(line.empty());
+  uut.push(line);
+  ASSERT_EQ(line, "go");
+}
+
+TEST(SpscQueue, AcrossThreads) {
+  constexpr auto count = 100000;
+  cxx::spsc_queue<int, 8> uut;
+
+  // the queue is much smaller than the number of values, so both threads have
+  // to wait on each other.
+  std::thread producer{[&uut] {
+    for (auto i = 0; i < count; ++i) {
+      auto value = i;
+      uut.push(value);
+    }
+  }};
+
+  for (auto i = 0; i < count; ++i) {
+    int value = -1;
+    uut.pop(value);
+    ASSERT_EQ(value, i);
+  }
+
+  producer.join();
+}
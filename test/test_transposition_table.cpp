@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <pawntificate/transposition_table.hpp>
+
+using pawntificate::bound;
+using pawntificate::move;
+using pawntificate::ptype;
+using pawntificate::square;
+using pawntificate::transposition;
+using pawntificate::transposition_table;
+
+TEST(TranspositionTable, EmptyTableMisses) {
+  transposition_table uut(1);
+
+  transposition result;
+  ASSERT_FALSE(uut.probe(0x1234u, result));
+  ASSERT_FALSE(uut.probe(0u, result));
+}
+
+TEST(TranspositionTable, StoreAndProbe) {
+  transposition_table uut(1);
+  uut.store(0x1234u, {move{square::e7, square::e8, ptype::queen, true}, -300, 5, bound::lower});
+
+  transposition result;
+  ASSERT_TRUE(uut.probe(0x1234u, result));
+  ASSERT_EQ(result.best, move(square::e7, square::e8, ptype::queen, true));
+  ASSERT_EQ(result.value, -300);
+  ASSERT_EQ(result.depth, 5u);
+  ASSERT_EQ(result.type, bound::lower);
+}
+
+TEST(TranspositionTable, DifferentKeySameSlot) {
+  transposition_table uut(1);
+  uut.store(0x1234u, {move{square::e2, square::e4}, 1, 1, bound::exact});
+
+  // the index only uses the low bits of the key.
+  transposition result;
+  ASSERT_FALSE(uut.probe(0x1234u | (1ull << 63u), result));
+}
+
+TEST(TranspositionTable, KeepsDeeperEntry) {
+  transposition_table uut(1);
+  uut.new_search();
+  uut.store(0x1234u, {move{square::e2, square::e4}, 10, 6, bound::exact});
+  uut.store(0x1234u, {move{square::d2, square::d4}, 20, 2, bound::upper});
+
+  transposition result;
+  ASSERT_TRUE(uut.probe(0x1234u, result));
+  ASSERT_EQ(result.best, move(square::e2, square::e4));
+
+  // but not from a previous search.
+  uut.new_search();
+  uut.store(0x1234u, {move{square::d2, square::d4}, 20, 2, bound::upper});
+  ASSERT_TRUE(uut.probe(0x1234u, result));
+  ASSERT_EQ(result.best, move(square::d2, square::d4));
+}
+
+TEST(TranspositionTable, Clear) {
+  transposition_table uut(1);
+  uut.store(0x1234u, {move{square::e2, square::e4}, 1, 1, bound::exact});
+  uut.clear();
+
+  transposition result;
+  ASSERT_FALSE(uut.probe(0x1234u, result));
+}
+
+TEST(TranspositionTable, HashFull) {
+  transposition_table uut(1);
+  uut.new_search();
+  ASSERT_EQ(uut.hashfull(), 0u);
+
+  // half of the sampled slots.
+  for (auto key = 0ull; key < 1000u; key += 2) {
+    uut.store(key, {move{square::e2, square::e4}, 1, 1, bound::exact});
+  }
+
+  ASSERT_EQ(uut.hashfull(), 500u);
+
+  // entries from a previous search don't count.
+  uut.new_search();
+  ASSERT_EQ(uut.hashfull(), 0u);
+}
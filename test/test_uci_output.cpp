@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <pawntificate/uci_output.hpp>
+
+using namespace std::chrono_literals;
+
+using pawntificate::move;
+using pawntificate::principal_variation;
+using pawntificate::square;
+
+TEST(UciOutput, Write) {
+  std::ostringstream os;
+  pawntificate::uci_output uut{os};
+  uut.write("readyok\n");
+  uut.write("uciok\n");
+  uut.flush();
+  ASSERT_EQ(os.str(), "readyok\nuciok\n");
+}
+
+TEST(UciOutput, Iteration) {
+  std::ostringstream os;
+  pawntificate::uci_output uut{os};
+
+  const std::vector<principal_variation> lines{
+    {35, {move{square::e2, square::e4}, move{square::e7, square::e5}}},
+    {pawntificate::mate - 3, {move{square::d2, square::d4}}}
+  };
+
+  pawntificate::search_info info;
+  info.depth = 5;
+  info.seldepth = 7;
+  info.nodes = 12000;
+  info.time = 20ms;
+  info.lines = lines;
+  info.hashfull = 42;
+  uut.info(info);
+  uut.flush();
+
+  ASSERT_EQ(os.str(),
+            "info depth 5 seldepth 7 multipv 1 score cp 35 nodes 12000 nps 600000 hashfull 42 time 20 pv e2e4 e7e5\n"
+            "info depth 5 seldepth 7 multipv 2 score mate 2 nodes 12000 nps 600000 hashfull 42 time 20 pv d2d4\n");
+}
+
+TEST(UciOutput, ProgressIsThrottled) {
+  std::ostringstream os;
+  pawntificate::uci_output uut{os, 100ms};
+
+  pawntificate::search_info info;
+  info.depth = 9;
+  info.currmove = move{square::g1, square::f3};
+  info.currmovenumber = 3;
+  info.nodes = 1000;
+
+  // too soon after the start of the search, then too soon after the last one.
+  for (const auto time : {50ms, 120ms, 150ms, 230ms}) {
+    info.time = time;
+    uut.info(info);
+  }
+
+  uut.flush();
+  ASSERT_EQ(os.str(),
+            "info depth 9 currmove g1f3 currmovenumber 3 nodes 1000 nps 8333 time 120\n"
+            "info depth 9 currmove g1f3 currmovenumber 3 nodes 1000 nps 4347 time 230\n");
+}
+
+TEST(UciOutput, Result) {
+  std::ostringstream os;
+  pawntificate::uci_output uut{os};
+
+  pawntificate::search_result result;
+  result.best = move{square::e7, square::e8, pawntificate::ptype::queen};
+  result.depth = 3;
+  result.nodes = 500;
+  result.time = 0ms;
+  result.lines.push_back({-(pawntificate::mate - 4), {result.best, move{square::a1, square::a8}}});
+  uut.result(result);
+  uut.flush();
+
+  ASSERT_EQ(os.str(),
+            "info multipv 1 depth 3 score mate -2 nodes 500 nps 500000 time 0 pv e7e8q a1a8\n"
+            "bestmove e7e8q ponder a1a8\n");
+}
+
+namespace {
+
+// a stream buffer that holds up every write until it is released.
+class stalled_buffer : public std::stringbuf {
+public:
+  auto release() -> void {
+    {
+      std::lock_guard guard{lock};
+      released = true;
+    }
+
+    ready.notify_all();
+  }
+
+protected:
+  auto xsputn(const char *s, const std::streamsize n) -> std::streamsize override {
+    std::unique_lock guard{lock};
+    ready.wait(guard, [this] { return released; });
+    return std::stringbuf::xsputn(s, n);
+  }
+
+private:
+  std::mutex lock;
+  std::condition_variable ready;
+  bool released = false;
+};
+
+} // unnamed namespace
+
+TEST(UciOutput, DropsUpdatesWhenFull) {
+  stalled_buffer buffer;
+  std::ostream os{&buffer};
+  pawntificate::uci_output uut{os};
+
+  const std::vector<principal_variation> lines{{0, {move{square::e2, square::e4}}}};
+  pawntificate::search_info info;
+  info.depth = 1;
+  info.lines = lines;
+
+  // far more than fits while the stream isn't taking anything.
+  constexpr auto iterations = 10000;
+  for (auto i = 0; i < iterations; ++i) {
+    uut.info(info);
+  }
+
+  pawntificate::search_result result;
+  result.best = move{square::e2, square::e4};
+
+  std::thread release{[&buffer] {
+    std::this_thread::sleep_for(50ms);
+    buffer.release();
+  }};
+
+  uut.result(result);
+  uut.flush();
+  release.join();
+
+  const auto out = buffer.str();
+  const auto written = std::count(std::begin(out), std::end(out), '\n');
+  ASSERT_LT(written, iterations);
+  ASSERT_TRUE(out.ends_with("bestmove e2e4\n"));
+}
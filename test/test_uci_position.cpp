@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/key_history.hpp>
+#include <pawntificate/uci_position.hpp>
+
+namespace {
+
+constexpr std::string_view kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+// the position and keys of playing the moves from scratch.
+auto replay(const std::string_view fen, const std::string_view moves) -> pawntificate::uci_position {
+  pawntificate::uci_position p;
+  EXPECT_TRUE(p.set(fen, moves));
+  return p;
+}
+
+auto expect_same(const pawntificate::uci_position &lhs, const pawntificate::uci_position &rhs) -> void {
+  EXPECT_EQ(lhs.position(), rhs.position());
+  EXPECT_EQ(lhs.position().hash, rhs.position().hash);
+  EXPECT_EQ(lhs.position().halfmove, rhs.position().halfmove);
+  ASSERT_EQ(lhs.history().size(), rhs.history().size());
+  if (lhs.history().size() > 0) {
+    EXPECT_EQ(lhs.history().back(), rhs.history().back());
+  }
+}
+
+} // unnamed namespace
+
+TEST(UciPosition, StartPosition) {
+  pawntificate::uci_position uut;
+  ASSERT_TRUE(uut.set("", ""));
+  ASSERT_EQ(uut.position(), pawntificate::board{});
+  ASSERT_EQ(uut.history().size(), 0u);
+}
+
+TEST(UciPosition, ExtendsMoves) {
+  pawntificate::uci_position uut;
+  ASSERT_TRUE(uut.set("", "e2e4"));
+  ASSERT_TRUE(uut.set("", "e2e4 e7e5"));
+  ASSERT_TRUE(uut.set("", "e2e4 e7e5 g1f3 b8c6"));
+  ASSERT_TRUE(uut.set("", "e2e4 e7e5 g1f3 b8c6"));
+  expect_same(uut, replay("", "e2e4 e7e5 g1f3 b8c6"));
+  ASSERT_EQ(uut.position(), pawntificate::board("e2e4 e7e5 g1f3 b8c6"));
+}
+
+TEST(UciPosition, ExtendsFromNoMoves) {
+  pawntificate::uci_position uut;
+  ASSERT_TRUE(uut.set(kiwipete, ""));
+  ASSERT_TRUE(uut.set(kiwipete, "e1g1 a6e2"));
+  expect_same(uut, replay(kiwipete, "e1g1 a6e2"));
+}
+
+TEST(UciPosition, DifferentMoves) {
+  // a takeback, a different move with the same prefix and a different game.
+  pawntificate::uci_position uut;
+  for (const auto moves : {"e2e4 e7e5 g1f3", "e2e4 e7e5", "e2e4 e7e6", "d2d4", "d2d4 d7d5 c2c4"}) {
+    ASSERT_TRUE(uut.set("", moves));
+    expect_same(uut, replay("", moves));
+  }
+}
+
+TEST(UciPosition, PromotionIsNotAPrefix) {
+  // the same squares but the second list promotes, it doesn't extend the first.
+  constexpr std::string_view fen = "4k3/1P6/8/8/8/8/8/4K3 w - - 0 1";
+  pawntificate::uci_position uut;
+  ASSERT_TRUE(uut.set(fen, "b7b8n"));
+  ASSERT_TRUE(uut.set(fen, "b7b8q e8d7"));
+  expect_same(uut, replay(fen, "b7b8q e8d7"));
+}
+
+TEST(UciPosition, DifferentStart) {
+  pawntificate::uci_position uut;
+  ASSERT_TRUE(uut.set("", "e2e4"));
+  ASSERT_TRUE(uut.set(kiwipete, "e2a6"));
+  expect_same(uut, replay(kiwipete, "e2a6"));
+  ASSERT_TRUE(uut.set("", "e2e4"));
+  expect_same(uut, replay("", "e2e4"));
+}
+
+TEST(UciPosition, InvalidFen) {
+  pawntificate::uci_position uut;
+  ASSERT_TRUE(uut.set("", "e2e4"));
+  ASSERT_FALSE(uut.set("not a fen", ""));
+  expect_same(uut, replay("", "e2e4"));
+}
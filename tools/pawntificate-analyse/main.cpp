@@ -0,0 +1,285 @@
+// analyses every position of an EPD file, as many at once as there are threads.
+//
+//   pawntificate-analyse [options] <in.epd> [out.epd]
+//
+//   --threads <n>     positions searched at once, every core by default
+//   --hash <mb>       size of the transposition table the searches share
+//   --nodes <n>       node budget of each search
+//   --movetime <ms>   time budget of each search
+//   --depth <n>       depth limit of each search
+//
+// the file is streamed: each thread takes the next line, searches it with an
+// engine of its own and a transposition table shared with the others, and the
+// results are written in the order of the input. each position is written back
+// with its search's score (ce), best move (bm), depth (acd) and node count
+// (acn), in place of any of those it had. its other operations are kept. the
+// output goes to stdout if no file is given, progress goes to stderr.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cxx/run_threads.hpp>
+#include <cxx/to_number.hpp>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/engine.hpp>
+#include <pawntificate/evaluate.hpp>
+#include <pawntificate/transposition_table.hpp>
+
+namespace {
+
+using namespace pawntificate;
+using cxx::to_number;
+
+constexpr std::size_t default_analyse_hash = 256ul;
+constexpr std::uint64_t default_analyse_nodes = 1000000ul;
+
+// progress is reported every this many positions.
+constexpr std::uint64_t report_interval = 1000ul;
+
+// epd gives mates as a score this far from 32767, in plies.
+constexpr int epd_mate = 32767;
+
+// the next whitespace separated token of text, which is moved past it.
+auto next_token(std::string_view &text) -> std::string_view {
+  const auto first = text.find_first_not_of(' ');
+  if (first == std::string_view::npos) {
+    text = {};
+    return {};
+  }
+
+  const auto last = std::min(text.find(' ', first), text.size());
+  const auto token = text.substr(first, last - first);
+  text.remove_prefix(last);
+  return token;
+}
+
+auto is_number(const std::string_view token) -> bool {
+  return !token.empty() && std::all_of(std::begin(token), std::end(token), [](const char c) {
+    return c >= '0' && c <= '9';
+  });
+}
+
+// the operations of an epd line after its four position fields, other than the
+// ones the analysis writes. a fen's move counters are dropped too.
+auto other_operations(std::string_view text) -> std::string {
+  auto rest = text;
+  if (is_number(next_token(rest)) && is_number(next_token(rest))) {
+    text = rest;
+  }
+
+  std::string kept;
+  while (!text.empty()) {
+    // an operation runs to the next semicolon that isn't in a string.
+    auto end = 0ul;
+    for (bool quoted = false; end < text.size() && (quoted || text[end] != ';'); ++end) {
+      quoted = quoted != (text[end] == '"');
+    }
+
+    auto op = text.substr(0, end);
+    text.remove_prefix(std::min(end + 1, text.size()));
+
+    auto operands = op;
+    const auto opcode = next_token(operands);
+    if (opcode.empty() || opcode == "ce" || opcode == "bm" || opcode == "acd" || opcode == "acn") {
+      continue;
+    }
+
+    op.remove_prefix(op.find_first_not_of(' '));
+    kept += ' ';
+    kept += op;
+    kept += ';';
+  }
+
+  return kept;
+}
+
+// the line written for a line of the input, unchanged if it isn't a position.
+auto analyse_line(const std::string &line, engine &e, const search_limits &limits, std::mt19937 &gen)
+    -> std::string {
+  board b;
+  if (!parse_fen(line, b)) {
+    return line;
+  }
+
+  std::string_view text{line};
+  std::string out;
+  for (auto i = 0; i < 4; ++i) {
+    out += i == 0 ? "" : " ";
+    out += next_token(text);
+  }
+
+  std::ostringstream os;
+  move_list moves;
+  find_legal_moves(b, moves);
+  if (moves.empty()) {
+    // the game is already over, there is nothing to search.
+    os << " ce " << (in_check(b) ? -epd_mate : 0) << "; acd 0; acn 0;";
+  } else {
+    search_result result;
+    e.start(b, key_history{}, limits, gen, [&result](const search_result &r) {
+      result = r;
+    });
+    e.wait();
+
+    const auto value = is_mate(result.value)
+      ? (result.value > 0 ? epd_mate - (mate - result.value) : -epd_mate + (mate + result.value))
+      : result.value;
+
+    os << " ce " << value << "; bm ";
+    to_san(os, b, result.best);
+    os << "; acd " << result.depth << "; acn " << result.nodes << ";";
+  }
+
+  return out + os.str() + other_operations(text);
+}
+
+// the lines of the input, handed out to the threads one at a time, and the
+// results, which are written out in the same order.
+struct analysis {
+  analysis(std::istream &in, std::ostream &out) : in{in}, out{out} {}
+
+  std::istream &in;
+  std::ostream &out;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  std::mutex lock;
+  std::uint64_t read = 0;
+  std::uint64_t written = 0;
+  std::uint64_t positions = 0;
+
+  // results that are finished but are waiting on an earlier line.
+  std::map<std::uint64_t, std::string> finished;
+
+  auto report() const -> void {
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "analysed " << positions << " positions in " << seconds << "s, "
+              << static_cast<double>(positions) / std::max(seconds, 1e-3) << " positions/s" << std::endl;
+  }
+};
+
+auto analyse_lines(analysis &a, transposition_table &tt, const search_limits &limits) -> void {
+  engine e(tt);
+  std::mt19937 gen;
+
+  std::string line;
+  while (true) {
+    std::uint64_t index;
+    {
+      std::lock_guard guard{a.lock};
+      if (!std::getline(a.in, line)) {
+        return;
+      }
+
+      index = a.read++;
+    }
+
+    auto result = analyse_line(line, e, limits, gen);
+    const bool position = result != line;
+
+    std::lock_guard guard{a.lock};
+    a.finished.emplace(index, std::move(result));
+    if (position && ++a.positions % report_interval == 0) {
+      a.report();
+    }
+
+    for (auto it = a.finished.begin(); it != a.finished.end() && it->first == a.written;
+         it = a.finished.erase(it)) {
+      a.out << it->second << '\n';
+      ++a.written;
+    }
+  }
+}
+
+auto usage() -> int {
+  std::cerr << "usage: pawntificate-analyse [--threads <n>] [--hash <mb>] [--nodes <n>] [--movetime <ms>]\n"
+            << "                            [--depth <n>] <in.epd> [out.epd]" << std::endl;
+  return 1;
+}
+
+} // unnamed namespace
+
+int main(int argc, char *argv[]) {
+  const std::vector<std::string_view> args(argv + 1, argv + argc);
+
+  std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::size_t hash = default_analyse_hash;
+  search_limits limits;
+  std::vector<std::string_view> files;
+
+  for (auto i = 0ul; i < args.size(); ++i) {
+    const auto value = i + 1 < args.size() ? args[i + 1] : std::string_view{};
+    if (args[i] == "--threads") {
+      threads = std::max(to_number(value, threads), 1ul);
+      ++i;
+    } else if (args[i] == "--hash") {
+      hash = std::max(to_number(value, hash), 1ul);
+      ++i;
+    } else if (args[i] == "--nodes") {
+      limits.nodes = to_number(value, 0);
+      ++i;
+    } else if (args[i] == "--movetime") {
+      limits.movetime = std::chrono::milliseconds{to_number(value, 0)};
+      ++i;
+    } else if (args[i] == "--depth") {
+      limits.depth = std::clamp(to_number(value, max_depth), 1ul, max_depth);
+      ++i;
+    } else if (args[i].starts_with("--")) {
+      return usage();
+    } else {
+      files.push_back(args[i]);
+    }
+  }
+
+  if (files.empty() || files.size() > 2) {
+    return usage();
+  }
+
+  // without a limit every search would run to the maximum depth.
+  if (limits.nodes == 0 && limits.movetime.count() == 0 && limits.depth == max_depth) {
+    limits.nodes = default_analyse_nodes;
+  }
+
+  std::ifstream in{std::string{files[0]}};
+  if (!in) {
+    std::cerr << "can't open " << files[0] << std::endl;
+    return 1;
+  }
+
+  std::ofstream file;
+  if (files.size() > 1) {
+    file.open(std::string{files[1]});
+    if (!file) {
+      std::cerr << "can't open " << files[1] << std::endl;
+      return 1;
+    }
+  }
+
+  // the whole run is one generation of the table, so no search ages the
+  // entries another is still using.
+  transposition_table tt{hash};
+  tt.new_search();
+  analysis a{in, files.size() > 1 ? file : std::cout};
+
+  cxx::run_threads(threads, [&](std::size_t) {
+    analyse_lines(a, tt, limits);
+  });
+
+  a.report();
+  if (!a.out.flush()) {
+    std::cerr << "failed to write " << (files.size() > 1 ? files[1] : "stdout") << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
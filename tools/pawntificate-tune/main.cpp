@@ -0,0 +1,483 @@
+// tunes the piece-square evaluation against the results of real games, the
+// texel method: the evaluation of a position is mapped through a sigmoid to an
+// expected score, and the parameters are fitted to minimise the squared error
+// against the game result over a large set of positions.
+//
+//   pawntificate-tune pack <positions.epd> <dataset.bin> [threads]
+//   pawntificate-tune tune <dataset.bin> <out.params> [iterations] [threads]
+//
+// pack reads positions labelled with the result of their game, one per line as
+// a FEN or EPD followed by the result ("1-0", "0-1", "1/2-1/2", or 1.0, 0.5,
+// 0.0), either as the last token of the line, optionally quoted or in brackets,
+// or as the operand of a c9 operation. each position is resolved to the quiet
+// position at the end of its quiescence search and stored in a compact fixed
+// size record. tune maps the packed records into memory, so the dataset can be
+// far larger than the memory it is tuned in, and writes parameters the engine
+// loads with its EvalParams option.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cxx/run_threads.hpp>
+#include <cxx/static_vector.hpp>
+#include <cxx/to_number.hpp>
+
+#include <pawntificate/board.hpp>
+#include <pawntificate/pawns.hpp>
+#include <pawntificate/psqt.hpp>
+#include <pawntificate/quiesce.hpp>
+
+namespace {
+
+using namespace pawntificate;
+using cxx::to_number;
+
+// a packed dataset is a header followed by count records, little endian.
+constexpr std::array<char, 4> magic{'p', 'w', 't', 'd'};
+constexpr std::uint32_t version = 1u;
+
+struct header {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  std::uint64_t count;
+};
+
+struct record {
+  // the quiet position, two piece opcodes per byte from a1, the lower nibble
+  // first.
+  std::array<std::uint8_t, 32> squares;
+
+  // the pawn structure terms, which aren't tuned.
+  std::int16_t pawn_mg;
+  std::int16_t pawn_eg;
+
+  // the result of the game in half points from white's point of view.
+  std::uint8_t result;
+  std::array<std::uint8_t, 3> padding;
+};
+
+static_assert(sizeof(header) == 16);
+static_assert(sizeof(record) == 40);
+
+// lines are read and packed this many at a time, so only that many are ever in
+// memory.
+constexpr std::size_t pack_chunk = 1ul << 16u;
+
+// the result label of a line: the operand of an epd c9 operation if it has
+// one, otherwise its last token. either may be quoted or in brackets.
+auto result_label(const std::string_view line) -> std::string_view {
+  std::string_view label;
+  if (const auto c9 = line.find(" c9 "); c9 != std::string_view::npos) {
+    label = line.substr(c9 + 4);
+    label = label.substr(0, label.find(';'));
+  } else {
+    label = line.substr(0, line.find_last_not_of(" ;\r") + 1);
+    label = label.substr(label.find_last_of(' ') + 1);
+  }
+
+  const auto first = label.find_first_not_of(" \"[");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+
+  return label.substr(first, label.find_last_not_of(" \"]") + 1 - first);
+}
+
+// the game result of a labelled line in half points for white. only the label
+// is read, so a number elsewhere on the line, like a move counter or another
+// operation's operand, can't be taken for the result.
+auto parse_result(const std::string_view line) -> std::optional<std::uint8_t> {
+  const auto label = result_label(line);
+  if (label == "1/2-1/2" || label == "0.5") {
+    return 1;
+  } else if (label == "1-0" || label == "1.0") {
+    return 2;
+  } else if (label == "0-1" || label == "0.0") {
+    return 0;
+  }
+
+  return std::nullopt;
+}
+
+// resolve a labelled line to a record, nothing if it can't be read or the
+// quiescence search finds a mate, which says nothing about the evaluation.
+auto pack_line(const std::string_view line, pawn_table &pawns) -> std::optional<record> {
+  const auto result = parse_result(line);
+  board b;
+  if (!result || !parse_fen(line, b)) {
+    return std::nullopt;
+  }
+
+  const auto q = quiesce(b, pawns);
+  if (is_mate(q.value)) {
+    return std::nullopt;
+  }
+
+  const auto &p = pawns.probe(q.leaf);
+  record r{};
+  for (auto s = 0ul; s < q.leaf.piece_board.size(); s += 2) {
+    r.squares[s / 2] = static_cast<std::uint8_t>(q.leaf.piece_board[s].opcode |
+                                                  q.leaf.piece_board[s + 1].opcode << 4u);
+  }
+
+  r.pawn_mg = static_cast<std::int16_t>(p.mg);
+  r.pawn_eg = static_cast<std::int16_t>(p.eg);
+  r.result = *result;
+  return r;
+}
+
+auto pack(const std::filesystem::path &input, const std::filesystem::path &output, const std::size_t threads)
+    -> int {
+  std::ifstream in{input};
+  std::ofstream out{output, std::ios::binary};
+  if (!in || !out) {
+    std::cerr << "can't open " << (in ? output : input) << std::endl;
+    return 1;
+  }
+
+  // the count is filled in once everything has been written.
+  header h{magic, version, 0};
+  out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+
+  std::vector<std::string> lines;
+  std::vector<std::optional<record>> records(pack_chunk);
+  std::uint64_t skipped = 0;
+  while (in) {
+    lines.clear();
+    for (std::string line; lines.size() < pack_chunk && std::getline(in, line);) {
+      lines.push_back(std::move(line));
+    }
+
+    std::atomic<std::size_t> next{0};
+    cxx::run_threads(threads, [&](std::size_t) {
+      pawn_table pawns;
+      for (auto i = next.fetch_add(1); i < lines.size(); i = next.fetch_add(1)) {
+        records[i] = pack_line(lines[i], pawns);
+      }
+    });
+
+    for (auto i = 0ul; i < lines.size(); ++i) {
+      if (records[i]) {
+        out.write(reinterpret_cast<const char *>(&*records[i]), sizeof(record));
+        ++h.count;
+      } else {
+        ++skipped;
+      }
+    }
+
+    std::cout << "packed " << h.count << " positions, skipped " << skipped << std::endl;
+  }
+
+  out.seekp(0);
+  out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+  if (!out.flush()) {
+    std::cerr << "failed to write " << output << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+// a packed dataset mapped read only into memory.
+class dataset {
+public:
+  dataset() = default;
+  dataset(const dataset &) = delete;
+  auto operator=(const dataset &) -> dataset & = delete;
+
+  ~dataset() {
+    if (mapping != nullptr) {
+      ::munmap(mapping, size);
+    }
+  }
+
+  auto open(const std::filesystem::path &path) -> bool {
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(header)) {
+      size = static_cast<std::size_t>(st.st_size);
+      auto m = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      mapping = m == MAP_FAILED ? nullptr : m;
+    }
+    ::close(fd);
+
+    if (mapping == nullptr) {
+      return false;
+    }
+
+    header h;
+    std::memcpy(&h, mapping, sizeof(h));
+    return h.magic == magic && h.version == version && size == sizeof(header) + h.count * sizeof(record);
+  }
+
+  auto records() const -> std::span<const record> {
+    const auto first = static_cast<const char *>(mapping) + sizeof(header);
+    return {reinterpret_cast<const record *>(first), (size - sizeof(header)) / sizeof(record)};
+  }
+
+private:
+  void *mapping = nullptr;
+  std::size_t size = 0;
+};
+
+// the parameters as one vector of doubles, the middlegame tables then the
+// endgame. each has the piece values first, then the raw tables by type.
+constexpr std::size_t values = 7ul;
+constexpr std::size_t phase_params = values + 7ul * 64ul;
+constexpr std::size_t param_count = 2ul * phase_params;
+
+auto to_vector(const psqt::parameters &params) -> std::vector<double> {
+  std::vector<double> v(param_count);
+  for (auto t = 0ul; t < values; ++t) {
+    v[t] = params.mg_value[t];
+    v[phase_params + t] = params.eg_value[t];
+    for (auto i = 0ul; i < 64ul; ++i) {
+      v[values + t * 64 + i] = params.mg_raw[t][i];
+      v[phase_params + values + t * 64 + i] = params.eg_raw[t][i];
+    }
+  }
+
+  return v;
+}
+
+auto to_parameters(const std::vector<double> &v) -> psqt::parameters {
+  const auto round = [](const double x) {
+    return static_cast<std::int16_t>(std::clamp(std::lround(x), -32767l, 32767l));
+  };
+
+  psqt::parameters params{};
+  for (auto t = 0ul; t < values; ++t) {
+    params.mg_value[t] = round(v[t]);
+    params.eg_value[t] = round(v[phase_params + t]);
+    for (auto i = 0ul; i < 64ul; ++i) {
+      params.mg_raw[t][i] = round(v[values + t * 64 + i]);
+      params.eg_raw[t][i] = round(v[phase_params + values + t * 64 + i]);
+    }
+  }
+
+  return params;
+}
+
+// the parameters a piece on a square adds to the evaluation, and which way.
+struct feature {
+  std::size_t value;
+  std::size_t square;
+  double sign;
+};
+
+// the features of a record, its phase and its evaluation in centipawns from
+// white's point of view, the same as the engine's apart from rounding.
+struct position {
+  cxx::static_vector<feature, 32> features;
+  double mg_weight;
+  double eg_weight;
+  double eval;
+};
+
+auto evaluate_record(const record &r, const std::vector<double> &v, position &pos) -> void {
+  pos.features.clear();
+  std::int32_t phase = 0;
+  double mg = r.pawn_mg;
+  double eg = r.pawn_eg;
+  for (auto s = 0ul; s < 64ul; ++s) {
+    const auto opcode = static_cast<std::uint8_t>((r.squares[s / 2] >> (s % 2 * 4u)) & 0xfu);
+    const auto type = static_cast<std::size_t>(opcode >> 1u);
+    if (type == 0 || type > 6 || pos.features.size() == pos.features.capacity()) {
+      continue;
+    }
+
+    // the same as the weight tables: the raw tables start from a8 and black's
+    // are mirrored.
+    const bool white = (opcode & 1u) != 0;
+    const feature f{type, values + type * 64ul + (white ? s ^ 56u : s), white ? 1.0 : -1.0};
+    pos.features.push_back(f);
+    mg += f.sign * (v[f.value] + v[f.square]);
+    eg += f.sign * (v[phase_params + f.value] + v[phase_params + f.square]);
+    phase += psqt::phase_weight[type];
+  }
+
+  const auto p = std::min(phase, psqt::max_phase);
+  pos.mg_weight = static_cast<double>(p) / psqt::max_phase;
+  pos.eg_weight = 1.0 - pos.mg_weight;
+  pos.eval = mg * pos.mg_weight + eg * pos.eg_weight;
+}
+
+// the expected score for white of an evaluation.
+auto sigmoid(const double k, const double eval) -> double {
+  return 1.0 / (1.0 + std::pow(10.0, -k * eval / 400.0));
+}
+
+// the mean squared error over the dataset, and its gradient if one is given.
+// each thread sums a contiguous share of the records into its own gradient, so
+// the result doesn't depend on the timing of the threads.
+auto loss(const std::span<const record> records,
+          const std::vector<double> &v,
+          const double k,
+          const std::size_t threads,
+          std::vector<double> *gradient) -> double {
+  std::vector<double> losses(threads);
+  std::vector<std::vector<double>> gradients(gradient != nullptr ? threads : 0);
+
+  cxx::run_threads(threads, [&](const std::size_t t) {
+    const auto first = records.size() * t / threads;
+    const auto last = records.size() * (t + 1) / threads;
+    std::vector<double> g(gradient != nullptr ? param_count : 0);
+    position pos;
+    double sum = 0.0;
+
+    for (auto i = first; i < last; ++i) {
+      evaluate_record(records[i], v, pos);
+      const auto s = sigmoid(k, pos.eval);
+      const auto error = records[i].result / 2.0 - s;
+      sum += error * error;
+
+      if (gradient != nullptr) {
+        // the derivative of the error with respect to the evaluation, then
+        // each feature moves the evaluation by its phase's share.
+        const auto d = -2.0 * error * s * (1.0 - s) * k * std::log(10.0) / 400.0;
+        for (const auto &f : pos.features) {
+          const auto mg = d * f.sign * pos.mg_weight;
+          const auto eg = d * f.sign * pos.eg_weight;
+          g[f.value] += mg;
+          g[f.square] += mg;
+          g[phase_params + f.value] += eg;
+          g[phase_params + f.square] += eg;
+        }
+      }
+    }
+
+    losses[t] = sum;
+    if (gradient != nullptr) {
+      gradients[t] = std::move(g);
+    }
+  });
+
+  const auto n = static_cast<double>(std::max(records.size(), 1ul));
+  if (gradient != nullptr) {
+    gradient->assign(param_count, 0.0);
+    for (const auto &g : gradients) {
+      for (auto i = 0ul; i < param_count; ++i) {
+        (*gradient)[i] += g[i] / n;
+      }
+    }
+  }
+
+  double sum = 0.0;
+  for (const auto l : losses) {
+    sum += l;
+  }
+
+  return sum / n;
+}
+
+// the scaling of the sigmoid that best fits the current parameters, found by a
+// golden section search.
+auto fit_k(const std::span<const record> records, const std::vector<double> &v, const std::size_t threads)
+    -> double {
+  const auto ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+  double lo = 0.0;
+  double hi = 4.0;
+  for (auto i = 0; i < 32; ++i) {
+    const auto a = hi - ratio * (hi - lo);
+    const auto b = lo + ratio * (hi - lo);
+    if (loss(records, v, a, threads, nullptr) < loss(records, v, b, threads, nullptr)) {
+      hi = b;
+    } else {
+      lo = a;
+    }
+  }
+
+  return (lo + hi) / 2.0;
+}
+
+auto tune(const std::filesystem::path &input,
+          const std::filesystem::path &output,
+          const std::size_t iterations,
+          const std::size_t threads) -> int {
+  dataset data;
+  if (!data.open(input)) {
+    std::cerr << "can't map " << input << " as a packed dataset" << std::endl;
+    return 1;
+  }
+
+  const auto records = data.records();
+  std::cout << "tuning on " << records.size() << " positions with " << threads << " threads" << std::endl;
+
+  auto v = to_vector(psqt::defaults);
+  const auto k = fit_k(records, v, threads);
+  std::cout << "k " << k << " loss " << loss(records, v, k, threads, nullptr) << std::endl;
+
+  // adam, with a step of about a centipawn.
+  constexpr double rate = 1.0;
+  constexpr double beta1 = 0.9;
+  constexpr double beta2 = 0.999;
+  constexpr double epsilon = 1e-8;
+  std::vector<double> gradient;
+  std::vector<double> m(param_count);
+  std::vector<double> s(param_count);
+  double beta1_t = 1.0;
+  double beta2_t = 1.0;
+
+  for (auto i = 1ul; i <= iterations; ++i) {
+    const auto l = loss(records, v, k, threads, &gradient);
+    beta1_t *= beta1;
+    beta2_t *= beta2;
+    for (auto p = 0ul; p < param_count; ++p) {
+      m[p] = beta1 * m[p] + (1.0 - beta1) * gradient[p];
+      s[p] = beta2 * s[p] + (1.0 - beta2) * gradient[p] * gradient[p];
+      v[p] -= rate * (m[p] / (1.0 - beta1_t)) / (std::sqrt(s[p] / (1.0 - beta2_t)) + epsilon);
+    }
+
+    // write the parameters out as we go so a long run can be stopped early.
+    if (i % 50 == 0 || i == iterations) {
+      std::cout << "iteration " << i << " loss " << l << std::endl;
+      if (!psqt::save_parameters(output, to_parameters(v))) {
+        std::cerr << "failed to write " << output << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+} // unnamed namespace
+
+int main(int argc, char *argv[]) {
+  const std::vector<std::string_view> args(argv + 1, argv + argc);
+  const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+  if (args.size() >= 3 && args[0] == "pack") {
+    const auto threads = std::max(to_number(args.size() > 3 ? args[3] : "", cores), 1ul);
+    return pack(args[1], args[2], threads);
+  } else if (args.size() >= 3 && args[0] == "tune") {
+    const auto iterations = to_number(args.size() > 3 ? args[3] : "", 500);
+    const auto threads = std::max(to_number(args.size() > 4 ? args[4] : "", cores), 1ul);
+    return tune(args[1], args[2], iterations, threads);
+  }
+
+  std::cerr << "usage: pawntificate-tune pack <positions.epd> <dataset.bin> [threads]\n"
+            << "       pawntificate-tune tune <dataset.bin> <out.params> [iterations] [threads]" << std::endl;
+  return 1;
+}
@@ -1,67 +1,324 @@
 // UCI front-end for the pawntificate engine.
-#include <filesystem>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
 
 #include <cxx/random.hpp>
+#include <cxx/spsc_queue.hpp>
+#include <cxx/to_number.hpp>
 
+#include <pawntificate/bench.hpp>
 #include <pawntificate/board.hpp>
+#include <pawntificate/engine.hpp>
 #include <pawntificate/evaluate.hpp>
 #include <pawntificate/uci_command.hpp>
+#include <pawntificate/uci_output.hpp>
+#include <pawntificate/uci_position.hpp>
 
-int main() {
-  static const auto rng_dump = std::filesystem::temp_directory_path() / "pawntificate.rng";
+namespace {
+
+using cxx::to_number;
+
+// parse a time in milliseconds. some guis send negative times when a clock is
+// about to run out, treat them as the smallest amount of time left.
+auto to_milliseconds(const std::string_view token) -> std::chrono::milliseconds {
+  long long value = 0;
+  std::from_chars(token.data(), token.data() + token.size(), value);
+  return std::chrono::milliseconds{std::max(value, 1ll)};
+}
+
+// example format: go wtime 303000 btime 301750 winc 3000 binc 3000
+// all times are in milliseconds. the moves of searchmoves are looked up in the
+// legal moves of the board, anything that isn't one is ignored.
+auto parse_go(pawntificate::uci_command &input, const pawntificate::board &b) -> pawntificate::search_limits {
+  pawntificate::search_limits limits;
+  bool depth = false;
+  auto token = input.next_token();
+  while (!token.empty()) {
+    if (token == "ponder") {
+      limits.ponder = true;
+    } else if (token == "infinite") {
+      limits.infinite = true;
+    } else if (token == "wtime") {
+      limits.wtime = to_milliseconds(input.next_token());
+    } else if (token == "btime") {
+      limits.btime = to_milliseconds(input.next_token());
+    } else if (token == "winc") {
+      limits.winc = std::chrono::milliseconds{to_number(input.next_token(), 0)};
+    } else if (token == "binc") {
+      limits.binc = std::chrono::milliseconds{to_number(input.next_token(), 0)};
+    } else if (token == "movestogo") {
+      limits.movestogo = to_number(input.next_token(), 0);
+    } else if (token == "movetime") {
+      limits.movetime = to_milliseconds(input.next_token());
+    } else if (token == "depth") {
+      limits.depth = std::clamp(to_number(input.next_token(), pawntificate::default_depth), 1ul,
+                                pawntificate::max_depth);
+      depth = true;
+    } else if (token == "nodes") {
+      limits.nodes = to_number(input.next_token(), 0);
+    } else if (token == "mate") {
+      limits.mate = to_number(input.next_token(), 0);
+    } else if (token == "searchmoves") {
+      pawntificate::move_list legal;
+      pawntificate::find_legal_moves(b, legal);
+
+      // the moves run up to the next keyword.
+      const auto is_move = [](const std::string_view t) {
+        return (t.size() == 4 || t.size() == 5) && t[0] >= 'a' && t[0] <= 'h' && t[1] >= '1' && t[1] <= '8' &&
+          t[2] >= 'a' && t[2] <= 'h' && t[3] >= '1' && t[3] <= '8';
+      };
+
+      for (token = input.next_token(); is_move(token); token = input.next_token()) {
+        for (const auto m : legal) {
+          std::ostringstream uci;
+          to_uci(uci, m);
+          if (uci.str() == token) {
+            limits.searchmoves.push_back(m);
+          }
+        }
+      }
+
+      continue;
+    }
+
+    token = input.next_token();
+  }
+
+  // without any limits we search to a fixed depth.
+  const bool limited = depth || limits.timed() || limits.movetime.count() > 0 || limits.nodes > 0 ||
+    limits.mate > 0 || limits.infinite;
+  if (!limited) {
+    limits.depth = pawntificate::default_depth;
+  }
+
+  return limits;
+}
+
+// format: bench [depth] [threads] [hash]
+// the bench positions are searched with an engine of their own, so that the
+// options and transposition table of the game aren't touched.
+auto run_bench(pawntificate::uci_output &output,
+               const std::string_view depth,
+               const std::string_view threads,
+               const std::string_view hash) -> void {
+  pawntificate::engine engine;
+  engine.set_threads(to_number(threads, 1));
+  engine.set_hash_size(std::clamp(to_number(hash, pawntificate::default_hash_size), 1ul, 4096ul));
+
+  const auto total = pawntificate::bench(
+    engine,
+    std::clamp(to_number(depth, pawntificate::default_bench_depth), 1ul, pawntificate::max_depth),
+    [&output](const auto i, const auto &result) {
+      std::ostringstream os;
+      os << "info string position " << i + 1 << '/' << pawntificate::bench_positions.size() << " bestmove ";
+      to_uci(os, result.best);
+      os << " nodes " << result.nodes << '\n';
+      output.write(os.str());
+    });
+
+  // the node count is the signature to compare between builds.
+  std::ostringstream os;
+  os << "Total time (ms) : " << total.time.count() << '\n'
+     << "Nodes searched  : " << total.nodes << '\n'
+     << "Nodes/second    : " << total.nps() << '\n';
+  output.write(os.str());
+}
+
+} // unnamed namespace
+
+int main(int argc, char *argv[]) {
   auto rng = cxx::make_random_engine<std::mt19937>();
 
-  // for debugging purposes we dump the rng state to disk before each evaluation
-  std::cout << "info string rng state stored at '" << rng_dump << "' before each move" << std::endl;
+  // for debugging purposes the rng state can be logged before each search, off
+  // unless the RngLog option names a file.
+  std::unique_ptr<cxx::random_engine_log<std::mt19937>> rng_log;
+
+  // the search runs on its own thread so that commands can still be handled
+  // while it is thinking, both threads write to stdout through here.
+  pawntificate::uci_output output{std::cout};
+
+  // pawntificate-uci bench [depth] [threads] [hash] runs the bench and exits.
+  if (argc > 1 && std::string_view{argv[1]} == "bench") {
+    const auto arg = [argc, argv](const int i) {
+      return i < argc ? std::string_view{argv[i]} : std::string_view{};
+    };
 
-  pawntificate::board board;
+    run_bench(output, arg(2), arg(3), arg(4));
+    return 0;
+  }
+
+  pawntificate::uci_position position;
+  pawntificate::engine engine;
+  engine.set_info_handler([&output](const auto &info) {
+    output.info(info);
+  });
+
+  // uci commands arrive from stdin. they are read on a thread of their own so
+  // that the pipe is always drained, however long this thread spends handling
+  // a command, and handed over in order through a queue. the end of the input
+  // is treated as a quit.
+  cxx::spsc_queue<std::string, 64> lines;
+  std::thread reader{[&lines] {
+    std::string line;
+    while (true) {
+      const bool eof = !std::getline(std::cin, line);
+      if (eof) {
+        line = "quit";
+      }
+
+      const bool quit = line == "quit" || line.starts_with("quit ");
+      lines.push(line);
+      if (quit) {
+        break;
+      }
+    }
+  }};
 
-  // uci commands arrive from stdin.
   pawntificate::uci_command input;
+  std::string line;
 
   while (true) {
     // block until a command is received.
-    input.read_line(std::cin);
+    lines.pop(line);
+    input.read_line(line);
 
     const auto cmd = input.next_token();
     if (cmd == "uci") {
-      std::cout << "id name pawntificate\n"
-                << "uciok\n";
+      std::ostringstream os;
+      os << "id name pawntificate\n"
+         << "option name Hash type spin default " << pawntificate::default_hash_size << " min 1 max 4096\n"
+         << "option name Threads type spin default 1 min 1 max " << pawntificate::max_threads << "\n"
+         << "option name MultiPV type spin default 1 min 1 max 256\n"
+         << "option name ParallelSearch type combo default LazySMP var LazySMP var YBWC\n"
+         << "option name Evaluator type combo default PSQT var PSQT var NNUE\n"
+         << "option name EvalFile type string default <empty>\n"
+         << "option name EvalParams type string default <empty>\n"
+         << "option name RngLog type string default <empty>\n"
+         << "option name InfoInterval type spin default 100 min 0 max 60000\n"
+         << "uciok\n";
+      output.write(os.str());
     } else if (cmd == "isready") {
-      std::cout << "readyok\n";
-    } else if (cmd == "position") {
-      const auto pos = input.next_token();
-      if (pos != "startpos") {
-        throw std::runtime_error("don't support custom position");
+      output.write("readyok\n");
+    } else if (cmd == "setoption") {
+      engine.wait();
+
+      // format: setoption name <id> value <x>
+      input.next_token();
+      const auto name = input.next_token();
+      input.next_token();
+      const auto value = input.next_token();
+
+      if (name == "Hash") {
+        engine.set_hash_size(to_number(value, pawntificate::default_hash_size));
+      } else if (name == "Threads") {
+        engine.set_threads(to_number(value, 1));
+      } else if (name == "MultiPV") {
+        engine.set_multi_pv(to_number(value, 1));
+      } else if (name == "ParallelSearch") {
+        engine.set_parallel_search(value == "YBWC"
+          ? pawntificate::parallel_search::tree_split
+          : pawntificate::parallel_search::shared_hash);
+      } else if (name == "Evaluator") {
+        engine.set_evaluator(value == "NNUE"
+          ? pawntificate::evaluator::nnue
+          : pawntificate::evaluator::psqt);
+      } else if (name == "EvalFile") {
+        const std::string path{value};
+        const auto loaded = engine.load_network(path);
+        output.write((loaded ? "info string loaded network " : "info string failed to load network ") + path + "\n");
+      } else if (name == "EvalParams") {
+        const std::string path{value};
+        const auto loaded = engine.load_parameters(path);
+        output.write((loaded ? "info string loaded parameters " : "info string failed to load parameters ") + path +
+                     "\n");
+      } else if (name == "InfoInterval") {
+        output.set_interval(std::chrono::milliseconds{to_number(value, 100)});
+      } else if (name == "RngLog") {
+        // the old log is finished and closed first, in case it is the same file.
+        rng_log.reset();
+        if (!value.empty() && value != "<empty>") {
+          const std::string path{value};
+          rng_log = std::make_unique<cxx::random_engine_log<std::mt19937>>(path);
+          output.write("info string rng state appended to " + path + " before each move\n");
+        }
       }
+    } else if (cmd == "bench") {
+      engine.stop();
+      engine.wait();
+
+      const auto depth = input.next_token();
+      const auto threads = input.next_token();
+      const auto hash = input.next_token();
+      run_bench(output, depth, threads, hash);
+    } else if (cmd == "ucinewgame") {
+      engine.stop();
+      engine.wait();
+      engine.new_game();
+    } else if (cmd == "position") {
+      // format: position [startpos | fen <fen>] [moves <move>...]
+      std::string_view fen;
+      auto token = input.next_token();
+      if (token == "fen") {
+        // the fen is every token up to the moves, it is parsed in place.
+        const auto first = input.next_token();
+        auto last = first;
+        for (token = input.next_token(); !token.empty() && token != "moves"; token = input.next_token()) {
+          last = token;
+        }
 
-      // after startpos there may be the token "moves" and a list of long
-      // algebraic notation moves after that keyword if it exists. build up a
-      // board representation from these moves.
-      const auto move_list = [&]() -> std::string_view {
-        if (input.next_token() == "moves") {
-          return input.all_tokens();
-        } else {
-          return "";
+        const auto length = static_cast<std::size_t>(last.data() + last.size() - first.data());
+        fen = {first.data(), length};
+        if (fen.empty()) {
+          output.write("info string missing fen\n");
+          continue;
         }
-      }();
-      board = pawntificate::board(move_list);
+      } else if (token == "startpos") {
+        token = input.next_token();
+      } else {
+        output.write("info string unknown position " + std::string{token} + "\n");
+        continue;
+      }
+
+      // after the position there may be the token "moves" and a list of long
+      // algebraic notation moves after that keyword if it exists. usually
+      // this is the last position sent plus a move or two, in which case only
+      // those are played.
+      const auto move_list = token == "moves" ? input.all_tokens() : std::string_view{};
+      if (!position.set(fen, move_list)) {
+        output.write("info string invalid fen " + std::string{fen} + "\n");
+      }
     } else if (cmd == "go") {
-      cxx::serialise_random_engine(rng, rng_dump);
+      // the last search may still be running after a stop, and it uses rng
+      // until it has finished.
+      engine.wait();
+      if (rng_log) {
+        rng_log->record(rng);
+      }
 
-      // example format: go wtime 303000 btime 301750 winc 3000 binc 3000
-      // all times are in milliseconds
-      //const auto info = pawntificate::parse_move_info(input.all_tokens());
+      const auto limits = parse_go(input, position.position());
 
-      // evaluate the last seen board position and return the best move.
-      std::cout << "bestmove ";
-      const auto bestmove = pawntificate::evaluate(board, rng);
-      to_uci(std::cout, bestmove) << std::endl;
+      // evaluate the last seen board position in the background, the best
+      // move is sent once the search finishes or is stopped.
+      engine.start(position.position(), position.history(), limits, rng, [&output](const auto &result) {
+        output.result(result);
+      });
+    } else if (cmd == "stop") {
+      engine.stop();
+    } else if (cmd == "ponderhit") {
+      engine.ponderhit();
     } else if (cmd == "quit") {
+      engine.stop();
+      engine.wait();
       break;
     }
   }
 
+  reader.join();
   return 0;
 }